@@ -1,10 +1,13 @@
 #include "Benchmark.h"
 
 #include <fstream>
+#include <iomanip>
 #include <vector>
 #include "xstring.h"
 
 #include "TriLogger.h"
+#include "BitBoard.h"
+#include "RKISS.h"
 #include "Searcher.h"
 #include "Transposition.h"
 #include "Thread.h"
@@ -133,8 +136,12 @@ void benchmark (istream &is, const Position &pos)
 
         if (limit_type == "perft")
         {
+            point perft_time = now ();
             uint64_t cnt = perft (root_pos, int32_t (limits.depth) * ONE_MOVE);
-            cerr << "\nPerft " << limits.depth  << " leaf nodes: " << cnt << "\n";
+            perft_time = now () - perft_time + 1;
+            cerr << "\nPerft " << limits.depth  << " leaf nodes: " << cnt
+                << "\nTime (ms)       : " << perft_time
+                << "\nNodes/second    : " << cnt * 1000 / perft_time << "\n";
             nodes += cnt;
         }
         else
@@ -154,3 +161,272 @@ void benchmark (istream &is, const Position &pos)
         << endl;
 
 }
+
+namespace {
+
+    const uint16_t NUM_OCC = 0x1000;
+    // 32 MB of noise read between the cold lookups, like the probes of a big TT
+    const uint32_t NUM_NOISE = 0x400000;
+
+    // Keeps the timed lookups from being optimized away
+    volatile Bitboard Sink;
+
+    // noise() reads a pseudo-random entry of the noise, evicting some cache lines
+    INLINE Bitboard noise (const vector<Bitboard> &noises, uint64_t &rnd)
+    {
+        rnd = rnd * U64 (6364136223846793005) + U64 (1442695040888963407);
+        return noises[(rnd >> 0x20) & (NUM_NOISE - 1)];
+    }
+
+    template<BitBoard::SliderT ST, PieceT PT, bool COLD>
+    // time_slider() returns the ticks spent in 'count' lookups of PT attacks with the ST backend,
+    // if COLD each lookup follows a read of the noise.
+    uint64_t time_slider (const vector<Bitboard> &occs, const vector<Bitboard> &noises, uint32_t count)
+    {
+        Bitboard sink = U64 (0);
+        uint64_t rnd  = U64 (0);
+        uint64_t ticks = cpu_ticks ();
+        for (uint32_t n = 0; n < count; ++n)
+        {
+            if (COLD) sink ^= noise (noises, rnd);
+            sink ^= BitBoard::attacks_slider<ST, PT> (Square (n & 0x3F), occs[(n >> 6) & (NUM_OCC - 1)]);
+        }
+        ticks = cpu_ticks () - ticks;
+        Sink = sink;
+        return ticks;
+    }
+
+    // time_noise() returns the ticks spent in 'count' reads of the noise alone
+    uint64_t time_noise (const vector<Bitboard> &noises, uint32_t count)
+    {
+        Bitboard sink = U64 (0);
+        uint64_t rnd  = U64 (0);
+        uint64_t ticks = cpu_ticks ();
+        for (uint32_t n = 0; n < count; ++n)
+        {
+            sink ^= noise (noises, rnd);
+        }
+        ticks = cpu_ticks () - ticks;
+        Sink = sink;
+        return ticks;
+    }
+
+    template<PieceT PT>
+    // time_ray() returns the ticks spent in 'count' ray walks of PT attacks
+    uint64_t time_ray (const vector<Bitboard> &occs, uint32_t count)
+    {
+        Bitboard sink = U64 (0);
+        uint64_t ticks = cpu_ticks ();
+        for (uint32_t n = 0; n < count; ++n)
+        {
+            sink ^= BitBoard::attacks_sliding (Square (n & 0x3F), BitBoard::_deltas_type[PT], occs[(n >> 6) & (NUM_OCC - 1)]);
+        }
+        ticks = cpu_ticks () - ticks;
+        Sink = sink;
+        return ticks;
+    }
+
+    template<BitBoard::SliderT ST>
+    // mismatches() counts the lookups of the ST backend differing from the ray walk
+    uint32_t mismatches (const vector<Bitboard> &occs)
+    {
+        uint32_t mismatch = 0;
+        for (uint16_t i = 0; i < NUM_OCC; ++i)
+        {
+            for (Square s = SQ_A1; s <= SQ_H8; ++s)
+            {
+                if (BitBoard::attacks_slider<ST, BSHP> (s, occs[i]) != BitBoard::attacks_sliding (s, BitBoard::_deltas_type[BSHP], occs[i])) ++mismatch;
+                if (BitBoard::attacks_slider<ST, ROOK> (s, occs[i]) != BitBoard::attacks_sliding (s, BitBoard::_deltas_type[ROOK], occs[i])) ++mismatch;
+            }
+        }
+        return mismatch;
+    }
+
+    typedef struct SliderStat
+    {
+        const char *name;
+        uint32_t    size;       // Bytes of the tables
+        uint32_t    mismatch;
+        uint64_t    ticks[2][2]; // [hot/cold][bishop/rook]
+    } SliderStat;
+
+    template<BitBoard::SliderT ST>
+    SliderStat slider_stat (const char *name, uint32_t size, const vector<Bitboard> &occs, const vector<Bitboard> &noises, uint32_t count)
+    {
+        SliderStat stat = { name, size, mismatches<ST> (occs),
+        {
+            { time_slider<ST, BSHP, false> (occs, noises, count), time_slider<ST, ROOK, false> (occs, noises, count) },
+            { time_slider<ST, BSHP, true > (occs, noises, count), time_slider<ST, ROOK, true > (occs, noises, count) },
+        } };
+        return stat;
+    }
+
+}
+
+// benchmark_sliders () times the sliding attacks of all the backends (fancy magic,
+// indexed with pext when built with BMI2, kindergarten, Sherwin and compact magic)
+// against the plain ray walk on the same random occupancies, after checking that
+// they all agree. Cold timings read a random entry of 32 MB before each lookup,
+// so that the tables compete for the cache as with the TT, the cost of the read
+// alone is subtracted.
+// There is one optional parameter:
+//  - number of lookups per piece type in millions (default is 10).
+// Timings in one binary compare the lookups only, the Makefile target 'slider-bench'
+// builds each backend into the engine to compare perft and search speed.
+void benchmark_sliders (istream &is)
+{
+    string token;
+    int32_t millions = (is >> token) ? max (1, atoi (token.c_str ())) : 10;
+    uint32_t count = uint32_t (millions) * 1000000;
+
+    // Backends not selected at compile time are built on demand
+    BitBoard::initialize_kg ();
+    BitBoard::initialize_sherwin ();
+    BitBoard::initialize_compact ();
+
+    // Three random words and-ed together give about 8 occupied squares
+    RKISS rkiss (0x1234);
+    vector<Bitboard> occs (NUM_OCC);
+    for (uint16_t i = 0; i < NUM_OCC; ++i)
+    {
+        occs[i] = rkiss.rand64 () & rkiss.rand64 () & rkiss.rand64 ();
+    }
+    vector<Bitboard> noises (NUM_NOISE, U64 (1));
+
+    const uint32_t magic_size = (BitBoard::MAX_B_MOVES + BitBoard::MAX_R_MOVES) * sizeof (Bitboard);
+    const SliderStat stats[4] =
+    {
+        slider_stat<BitBoard::SLD_MAGIC> (
+#if defined(BMI2)
+        "pext   ",
+#else
+        "magic  ",
+#endif
+            magic_size, occs, noises, count),
+        slider_stat<BitBoard::SLD_KG> ("kg     ", sizeof (BitBoard::KGFillUp_bb) + sizeof (BitBoard::KGFileA_bb), occs, noises, count),
+        slider_stat<BitBoard::SLD_SHERWIN> ("sherwin", sizeof (BitBoard::SWBRows) + sizeof (BitBoard::SWRRows) + sizeof (BitBoard::SWBTable_bb) + sizeof (BitBoard::SWRTable_bb), occs, noises, count),
+        slider_stat<BitBoard::SLD_COMPACT> ("compact", (BitBoard::MAX_B_MOVES + BitBoard::MAX_R_MOVES) * sizeof (uint16_t) + (BitBoard::BAttackSets + BitBoard::RAttackSets) * sizeof (Bitboard), occs, noises, count),
+    };
+    uint64_t noise_ticks = time_noise (noises, count);
+
+    cerr << "\n===========================\n"
+        << "Lookups per type: " << count << "\n"
+        << "                       Hot ticks/lookup  Cold ticks/lookup\n"
+        << "Backend         Size KB  Bishop    Rook  Bishop    Rook  Mismatches\n" << fixed << setprecision (2);
+    for (uint8_t b = 0; b < 4; ++b)
+    {
+        cerr << stats[b].name << (BitBoard::SLIDER == b ? " (used)" : "       ") << ": "
+            << setw (7) << (stats[b].size + 1023) / 1024
+            << setw (8) << double (stats[b].ticks[0][0]) / count
+            << setw (8) << double (stats[b].ticks[0][1]) / count
+            << setw (8) << (double (stats[b].ticks[1][0]) - double (noise_ticks)) / count
+            << setw (8) << (double (stats[b].ticks[1][1]) - double (noise_ticks)) / count
+            << setw (12) << stats[b].mismatch << "\n";
+    }
+    cerr << "ray           :        "
+        << setw (8) << double (time_ray<BSHP> (occs, count)) / count
+        << setw (8) << double (time_ray<ROOK> (occs, count)) / count << "\n"
+        << endl;
+}
+
+// benchmark_fen () measures the setup throughput in positions/second of the bulk
+// loader Position::load () against Position::parse () on the same records, and
+// checks that both give the same positions.
+// There are two optional parameters:
+//  - filename of FEN or EPD records, one per line (defaults are the positions defined above),
+//  - number of passes over the records (default is 1000 for the default positions, else 1).
+void benchmark_fen (istream &is)
+{
+    string token;
+    string fen_fn = (is >> token) ? token : "default";
+
+    vector<string> fens;
+    if (iequals (fen_fn, "default"))
+    {
+        fens.assign (default_fens, default_fens + NUM_FEN);
+    }
+    else
+    {
+        ifstream fstm_fen (fen_fn.c_str ());
+
+        if (!fstm_fen.is_open ())
+        {
+            cerr << "ERROR: Unable to open file ... \'" << fen_fn << "\'" << endl;
+            return;
+        }
+
+        string fen;
+        while (getline (fstm_fen, fen))
+        {
+            if (!fen.empty ())
+            {
+                fens.push_back (fen);
+            }
+        }
+        fstm_fen.close ();
+    }
+    int32_t passes = (is >> token) ? max (1, atoi (token.c_str ())) : (iequals (fen_fn, "default") ? 1000 : 1);
+
+    // All the records in one buffer, as read by an import job
+    string buffer;
+    vector<uint32_t> offsets;
+    for (uint32_t i = 0; i < fens.size (); ++i)
+    {
+        offsets.push_back (buffer.size ());
+        buffer += fens[i];
+        buffer += '\n';
+    }
+
+    bool chess960 = *(Options["UCI_Chess960"]);
+    Position pos (int8_t (0));
+    Position ref (int8_t (0));
+
+    // Only the valid records are timed, parse() does not check them all
+    vector<uint32_t> valids;
+    uint32_t mismatch = 0;
+    for (uint32_t i = 0; i < fens.size (); ++i)
+    {
+        if (!Position::load (pos, buffer.c_str () + offsets[i], NULL, chess960)) continue;
+        valids.push_back (i);
+        Position::parse (ref, fens[i], NULL, chess960);
+        if (   pos.fen () != ref.fen ()
+            || pos.matl_key () != ref.matl_key ()
+            || pos.pawn_key () != ref.pawn_key ()
+            || pos.posi_key () != ref.posi_key ()
+            || !pos.ok ())
+        {
+            cerr << "Mismatch: " << fens[i] << "\n";
+            ++mismatch;
+        }
+    }
+
+    uint64_t count = uint64_t (passes) * valids.size ();
+
+    uint64_t parse_time = system_time_usec ();
+    for (int32_t p = 0; p < passes; ++p)
+    {
+        for (uint32_t v = 0; v < valids.size (); ++v)
+        {
+            Position::parse (ref, fens[valids[v]], NULL, chess960);
+        }
+    }
+    parse_time = system_time_usec () - parse_time + 1;
+
+    uint64_t load_time = system_time_usec ();
+    for (int32_t p = 0; p < passes; ++p)
+    {
+        for (uint32_t v = 0; v < valids.size (); ++v)
+        {
+            Position::load (pos, buffer.c_str () + offsets[valids[v]], NULL, chess960);
+        }
+    }
+    load_time = system_time_usec () - load_time + 1;
+
+    cerr << "\n===========================\n"
+        << "Records         : " << fens.size () << " x " << passes << "\n"
+        << "Invalid         : " << fens.size () - valids.size () << "\n"
+        << "Mismatches      : " << mismatch << "\n"
+        << "parse (pos/sec) : " << count * 1000000 / parse_time << "\n"
+        << "load  (pos/sec) : " << count * 1000000 / load_time
+        << endl;
+}
@@ -8,4 +8,8 @@
 
 extern void benchmark (std::istream &is, const Position &pos);
 
+extern void benchmark_sliders (std::istream &is);
+
+extern void benchmark_fen (std::istream &is);
+
 #endif
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "BitBases.h"
 
 #include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
 #include "BitBoard.h"
 #include "BitScan.h"
 
@@ -15,9 +18,6 @@ namespace BitBases {
         // There are 24 possible pawn squares: the first 4 files and ranks from 2 to 7
         const uint32_t MAX_INDEX = 2*24*64*64; // stm * p_sq * wk_sq * bk_sq = 196608
 
-        // Each uint32_t stores results of 32 positions, one per bit
-        uint32_t KPKBitbase[MAX_INDEX / 32];
-
         // A KPK bitbase index is an integer in [0, MAX_INDEX] range
         //
         // Information is mapped in a way that minimizes the number of iterations:
@@ -151,8 +151,19 @@ namespace BitBases {
 
     }
 
-    void initialize ()
+    // Each uint32_t stores results of 32 positions, one per bit.
+    // The table is generated offline by generate_kpk(), so nothing is computed at startup.
+    const uint32_t KPKBitbase[KPK_SIZE] =
+    {
+#       include "BitBases.KPK.h"
+    };
+
+    // generate_kpk() classifies all the KPK positions by retrograde analysis
+    // and stores the wins in the given bitbase, as embedded in KPKBitbase[].
+    void generate_kpk (uint32_t bitbase[KPK_SIZE])
     {
+        std::fill (bitbase, bitbase + KPK_SIZE, 0);
+
         vector<KPKPosition> db;
         db.reserve (MAX_INDEX);
 
@@ -181,11 +192,27 @@ namespace BitBases {
         {
             if (WIN == db[idx])
             {
-                KPKBitbase[idx / 32] |= 1 << (idx & 0x1F);
+                bitbase[idx / 32] |= 1 << (idx & 0x1F);
             }
         }
     }
 
+    // write_kpk() writes the generated KPK bitbase in the layout of BitBases.KPK.h,
+    // 8 words per line. Run "kpk" (or make kpk) to regenerate that file.
+    void write_kpk (ostream &os)
+    {
+        vector<uint32_t> kpk (KPK_SIZE);
+        generate_kpk (&kpk[0]);
+
+        os << "// KPK bitbase, generated by BitBases::generate_kpk () with the \"kpk\" command, do not edit.\n";
+        for (uint32_t i = 0; i < KPK_SIZE; ++i)
+        {
+            os  << "0x" << hex << uppercase << setfill ('0') << setw (8) << kpk[i] << ","
+                << ((i & 7) == 7 ? "\n" : " ");
+        }
+        os << dec << nouppercase << setfill (' ');
+    }
+
     bool probe_kpk (Color c, Square wk_sq, Square wp_sq, Square bk_sq)
     {
         ASSERT (_file (wp_sq) <= F_D);
@@ -2,11 +2,19 @@
 #ifndef BITBASES_H_
 #define BITBASES_H_
 
+#include <iosfwd>
 #include "Type.h"
 
 namespace BitBases {
 
-    void initialize ();
+    // Words of the KPK bitbase, 32 positions each
+    const uint32_t KPK_SIZE = 2*24*64*64 / 32;
+
+    extern const uint32_t KPKBitbase[KPK_SIZE];
+
+    void generate_kpk (uint32_t bitbase[KPK_SIZE]);
+
+    void write_kpk (std::ostream &os);
 
     bool probe_kpk (Color c, Square wk_sq, Square wp_sq, Square bk_sq);
 
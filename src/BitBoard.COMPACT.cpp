@@ -0,0 +1,69 @@
+#include "BitBoard.h"
+#include "BitCount.h"
+
+namespace BitBoard {
+
+    namespace {
+
+        // Distinct attack sets of a slider on a square are the product of its ray lengths,
+        // summed over the squares: 1428 for the bishop and 4900 for the rook,
+        // plus one more set per square for the unused entries
+        const uint16_t MAX_B_SETS = U32 (1428 + 64);
+        const uint16_t MAX_R_SETS = U32 (4900 + 64);
+
+        CACHE_ALIGN(64) uint16_t BTable16[MAX_B_MOVES];
+        CACHE_ALIGN(64) uint16_t RTable16[MAX_R_MOVES];
+
+        // initialize_table16() replaces every attack set of the magic tables by its 16-bit
+        // reference into set_bb[], sets are only shared within the square.
+        void initialize_table16 (uint16_t table16[], uint16_t* attacks16[], Bitboard set_bb[], uint16_t &sets, Bitboard* const attacks_bb[], const Bitboard masks_bb[])
+        {
+            sets = 0;
+            attacks16[SQ_A1] = table16;
+
+            for (Square s = SQ_A1; s <= SQ_H8; ++s)
+            {
+                uint32_t size = U32 (1) << pop_count<MAX15> (masks_bb[s]);
+                uint16_t first = sets;
+
+                for (uint32_t i = 0; i < size; ++i)
+                {
+                    // Unused entries (constructive collisions) stay zero, so share a set too
+                    Bitboard attacks = attacks_bb[s][i];
+
+                    uint16_t ref = first;
+                    while (ref < sets && set_bb[ref] != attacks) ++ref;
+                    if (ref == sets) set_bb[sets++] = attacks;
+
+                    attacks16[s][i] = ref;
+                }
+
+                if (s < SQ_H8)
+                {
+                    attacks16[s + 1] = attacks16[s] + size;
+                }
+            }
+        }
+
+    }
+
+    CACHE_ALIGN(64) uint16_t*BAttack16[SQ_NO];
+    CACHE_ALIGN(64) uint16_t*RAttack16[SQ_NO];
+
+    CACHE_ALIGN(64) Bitboard BAttackSet_bb[MAX_B_SETS];
+    CACHE_ALIGN(64) Bitboard RAttackSet_bb[MAX_R_SETS];
+
+    uint16_t BAttackSets;
+    uint16_t RAttackSets;
+
+    // initialize_compact() must be called after initialize_sliding()
+    void initialize_compact ()
+    {
+        initialize_table16 (BTable16, BAttack16, BAttackSet_bb, BAttackSets, BAttack_bb, BMask_bb);
+        initialize_table16 (RTable16, RAttack16, RAttackSet_bb, RAttackSets, RAttack_bb, RMask_bb);
+
+        ASSERT (BAttackSets <= MAX_B_SETS);
+        ASSERT (RAttackSets <= MAX_R_SETS);
+    }
+
+}
@@ -4,7 +4,6 @@
 
 #include "BitCount.h"
 #include "BitScan.h"
-#include "RKISS.h"
 
 namespace BitBoard {
 
@@ -280,43 +279,106 @@ namespace BitBoard {
 
     namespace {
 
-        // max moves for rook from any corner square
-        // 2 ^ 12 = 4096 = 0x1000
-        const uint16_t MAX_MOVES =   U32 (0x1000);
-
-        // 4 * 2^9 + 4 * 2^6 + 12 * 2^7 + 44 * 2^5
-        // 4 * 512 + 4 *  64 + 12 * 128 + 44 *  32
-        //    2048 +     256 +     1536 +     1408
-        //                                    5248 = 0x1480
-        const uint32_t MAX_B_MOVES = U32 (0x1480);
-
-        // 4 * 2^12 + 24 * 2^11 + 36 * 2^10
-        // 4 * 4096 + 24 * 2048 + 36 * 1024
-        //    16384 +     49152 +     36864
-        //                           102400 = 0x19000
-        const uint32_t MAX_R_MOVES = U32 (0x19000);
-
-
         CACHE_ALIGN(64) Bitboard BTable_bb[MAX_B_MOVES];
         CACHE_ALIGN(64) Bitboard RTable_bb[MAX_R_MOVES];
 
-        typedef uint16_t (*Indexer) (Square s, Bitboard occ);
+        // Fixed magics found once with the RKISS boosted search and checked against
+        // every occupancy subset of the mask, so initialization is a plain table fill.
+        // The 32-bit indexer folds the product into 32 bits and needs its own set.
+#if defined(_64BIT)
 
-        void initialize_table (Bitboard table_bb[], Bitboard* attacks_bb[], Bitboard magics_bb[], Bitboard masks_bb[], uint8_t shift[], const Delta deltas[], const Indexer indexer)
+        // Verified bishop magics, one per square (A1..H8)
+        const Bitboard BMagics[SQ_NO] =
+        {
+            U64 (0x0008026082040100), U64 (0x4112140810851214), U64 (0x4A044C0086000800), U64 (0x1008084101044000),
+            U64 (0x000404200030C106), U64 (0x0001043241020008), U64 (0x0004008809482010), U64 (0x0802004044042102),
+            U64 (0x8000101090014040), U64 (0x8090420842040040), U64 (0x004110008081100A), U64 (0x1000282048450004),
+            U64 (0x0000220210040818), U64 (0x8004488804420A08), U64 (0x0489490801100800), U64 (0x0000002488082800),
+            U64 (0x0004022120420200), U64 (0x020820041000A200), U64 (0x0249009004002044), U64 (0x0808000082004301),
+            U64 (0x0904010200940000), U64 (0x0002008509100204), U64 (0x2000909108191008), U64 (0x130A004041009880),
+            U64 (0x04904000B01A0640), U64 (0x0946280021480280), U64 (0x2800410128080104), U64 (0x000C040180401180),
+            U64 (0x8001010120104000), U64 (0x0002120008C80201), U64 (0x0102020200809000), U64 (0x9141084002004400),
+            U64 (0x0011201240285020), U64 (0x0800880828208241), U64 (0x8116024044241101), U64 (0x0000401008020208),
+            U64 (0x0086008400020220), U64 (0x0001120200418806), U64 (0x80010E1400008418), U64 (0x0001D388820A0204),
+            U64 (0x00040A2050001412), U64 (0x0001211030440201), U64 (0x84000C0048020C06), U64 (0xC004082019040804),
+            U64 (0x0406200414000C40), U64 (0x4208100042900200), U64 (0x00130880C300840C), U64 (0x48020C8200840206),
+            U64 (0x004CC33008A0900A), U64 (0x0201041A120200A2), U64 (0x2900102108082000), U64 (0x8400001084040000),
+            U64 (0x4A92004002820400), U64 (0x8000420204110004), U64 (0x2024200424448088), U64 (0x8120014210910008),
+            U64 (0x4022042401141004), U64 (0x20C2020282280300), U64 (0x110000C084108800), U64 (0xC900100240420200),
+            U64 (0x2000000040104108), U64 (0x0020402025101882), U64 (0x0000080230020218), U64 (0x0020010408004041),
+        };
+
+        // Verified rook magics, one per square (A1..H8)
+        const Bitboard RMagics[SQ_NO] =
         {
+            U64 (0x0080014004295080), U64 (0x3040002000401007), U64 (0x1280088010012002), U64 (0x0E80080090008004),
+            U64 (0x8880080004000380), U64 (0x2080014200800400), U64 (0x9400008402100801), U64 (0x010001000040912A),
+            U64 (0x0111800080204000), U64 (0xA000C01001200041), U64 (0x0004801000802000), U64 (0x0448800802100080),
+            U64 (0x0011000413000800), U64 (0x0001800400800600), U64 (0x2006000E00880344), U64 (0x0802000041288204),
+            U64 (0x0154828000204008), U64 (0x0010004040002001), U64 (0x0002110020010640), U64 (0x0021010008100022),
+            U64 (0x8204008008008005), U64 (0x4109010002040008), U64 (0x0020240010521801), U64 (0x0900020021108044),
+            U64 (0x0000802080004000), U64 (0x0150005040002000), U64 (0x1001004100200018), U64 (0x4801010900201001),
+            U64 (0x0000040080800800), U64 (0x0014020080800400), U64 (0x8002040101000200), U64 (0x4200802880084100),
+            U64 (0x0808804202002100), U64 (0x0120002081804000), U64 (0x0000200041001108), U64 (0xD000080080801000),
+            U64 (0x1008800400800800), U64 (0x2200800200800400), U64 (0x0001681004005201), U64 (0x4058010042002084),
+            U64 (0x0280002002414000), U64 (0x0240400081010022), U64 (0x1000200010008080), U64 (0x0080080010008080),
+            U64 (0x0208001100090004), U64 (0x0001002400030008), U64 (0x0020020004010100), U64 (0x0201140448820001),
+            U64 (0x0080082080410900), U64 (0x02C0003043890100), U64 (0x4020200080500180), U64 (0x1524201001000900),
+            U64 (0x0808000810050100), U64 (0x0400040002008080), U64 (0x1400100201080400), U64 (0x0082009044010200),
+            U64 (0x0005028000215041), U64 (0x0004400100241081), U64 (0x0340102000090041), U64 (0xD004210004081001),
+            U64 (0x8042001020040802), U64 (0x000A00A803101402), U64 (0x8002020088015004), U64 (0x014005082C084082),
+        };
 
-            uint16_t _bMagicBoosters[R_NO] =
-#if defined(_64BIT)
-            { 0x423, 0xE18, 0x25D, 0xCA2, 0xCFE, 0x026, 0x7ED, 0xBE3, }; // 64-bit
 #else
-            { 0xC77, 0x888, 0x51E, 0xE22, 0x82B, 0x51C, 0x994, 0xF9C, }; // 32-bit
-#endif
 
-            Bitboard occupancy[MAX_MOVES];
-            Bitboard reference[MAX_MOVES];
+        // Verified bishop magics, one per square (A1..H8)
+        const Bitboard BMagics[SQ_NO] =
+        {
+            U64 (0x4442404200110110), U64 (0x0480285424892214), U64 (0x0082200002280485), U64 (0x0018006040880841),
+            U64 (0x2241300008420210), U64 (0x2000401804C22104), U64 (0x204C100808084208), U64 (0x0128080100201202),
+            U64 (0x0101063020001010), U64 (0x08023020800004C4), U64 (0x84408801082A5204), U64 (0x0041000340404886),
+            U64 (0x062802004C080C45), U64 (0x2010004204A00103), U64 (0x1042488002642202), U64 (0x0CB4240104010514),
+            U64 (0x200404020018110D), U64 (0x440C40525020080D), U64 (0x9063084000120001), U64 (0x2012800000020C01),
+            U64 (0x410C200804204824), U64 (0x8301018010050102), U64 (0x0806901300085205), U64 (0x5482820410808041),
+            U64 (0x0808290000202004), U64 (0x1012020402892000), U64 (0x5262008000040480), U64 (0x0040108122004400),
+            U64 (0x3020208816408240), U64 (0x0101080862104E40), U64 (0xAC03010200462481), U64 (0x061486088A012420),
+            U64 (0x2030022200182048), U64 (0x1488080000080252), U64 (0x080104001050C350), U64 (0x0100818400410208),
+            U64 (0x0410804202810101), U64 (0x0000828000011069), U64 (0x82220100A0014604), U64 (0x000208C80880810D),
+            U64 (0xB904040084244221), U64 (0x2000460A02890C02), U64 (0x1108101204004024), U64 (0x1088011008010485),
+            U64 (0x04001042101C2841), U64 (0x00200644000A2008), U64 (0x0068010108181001), U64 (0x520003202002C202),
+            U64 (0xC250158340012108), U64 (0x2202024044008404), U64 (0x4812000040188062), U64 (0x4082090284140101),
+            U64 (0x020200020045A090), U64 (0x484200010003080A), U64 (0x020C0040480B1411), U64 (0x40411005012004A1),
+            U64 (0x2802231810008581), U64 (0x0218222410803262), U64 (0x4080904A000E0301), U64 (0x910488000401C809),
+            U64 (0x8420822120328020), U64 (0x1202020011004484), U64 (0x040105000A003302), U64 (0x45050830000C0110),
+        };
+
+        // Verified rook magics, one per square (A1..H8)
+        const Bitboard RMagics[SQ_NO] =
+        {
+            U64 (0x8840800800101121), U64 (0x003E004020400020), U64 (0x8230420044010084), U64 (0x0008C01204008024),
+            U64 (0x8041005084080834), U64 (0x0040029900400334), U64 (0x0101020000800083), U64 (0xA400208880200041),
+            U64 (0x1000600004402030), U64 (0x40C0600000004010), U64 (0x4480122181408060), U64 (0x000A028001008030),
+            U64 (0x2200906041022041), U64 (0x6008102020840104), U64 (0x0282508000008001), U64 (0x0006C00840088081),
+            U64 (0x00C6219091900040), U64 (0x4A214008000C0808), U64 (0x100408C80140A020), U64 (0x0A49100000008808),
+            U64 (0x0044009560420808), U64 (0x0041100200840042), U64 (0x0004012200904A02), U64 (0x1010468004C44101),
+            U64 (0x2292284221025182), U64 (0x88354080800208C2), U64 (0x4082001919024422), U64 (0x4100100003400821),
+            U64 (0x0100080080141015), U64 (0x2A2C001200000901), U64 (0x00120A110C8A9014), U64 (0x09C0410400000082),
+            U64 (0x10404020006A408C), U64 (0x0040005000082132), U64 (0x348010001100A020), U64 (0x0100082000401001),
+            U64 (0x0410080044801004), U64 (0x9040060000004091), U64 (0x0100220A10400401), U64 (0x20801080080400C1),
+            U64 (0x006480000C049040), U64 (0x50004002000C4020), U64 (0x0404080402024114), U64 (0x1001001822002089),
+            U64 (0x2040408802080402), U64 (0x00804140968C8211), U64 (0x2008083000000322), U64 (0x001C808042900061),
+            U64 (0x00400A8000022880), U64 (0x220128100BC00408), U64 (0x008640802002A010), U64 (0x0048034040001004),
+            U64 (0x080840800081A004), U64 (0x000289000000201C), U64 (0x04C0202004085601), U64 (0x4088430000144881),
+            U64 (0x0300501290002492), U64 (0x00810C2120009040), U64 (0x488020164800084A), U64 (0x1850000560407109),
+            U64 (0x0100121104800428), U64 (0x080402010005280C), U64 (0x410000D3024804AA), U64 (0x4000244B51400081),
+        };
+
+#endif
 
-            RKISS rkiss;
+        typedef uint16_t (*Indexer) (Square s, Bitboard occ);
 
+        void initialize_table (Bitboard table_bb[], Bitboard* attacks_bb[], Bitboard magics_bb[], Bitboard masks_bb[], uint8_t shift[], const Delta deltas[], const Bitboard magics[], const Indexer indexer)
+        {
             attacks_bb[SQ_A1] = table_bb;
 
             for (Square s = SQ_A1; s <= SQ_H8; ++s)
@@ -340,71 +402,37 @@ namespace BitBoard {
                     32 - pop_count<MAX15> (mask);
 #endif
 
-                // Use Carry-Rippler trick to enumerate all subsets of masks_bb[s] and
-                // store the corresponding sliding attack bitboard in reference[].
-                uint32_t size   = 0;
-                Bitboard occ    = U64 (0);
-                do
-                {
-                    occupancy[size] = occ;
-                    reference[size] = attacks_sliding (s, deltas, occ);
-                    ++size;
-                    occ = (occ - mask) & mask;
-                }
-                while (occ);
+                magics_bb[s] = magics[s];
 
                 // Set the offset for the table_bb of the next square. We have individual
                 // table_bb sizes for each square with "Fancy Magic Bitboards".
                 if (s < SQ_H8)
                 {
-                    attacks_bb[s + 1] = attacks_bb[s] + size;
+                    attacks_bb[s + 1] = attacks_bb[s] + (U32 (1) << pop_count<MAX15> (mask));
                 }
 
-                uint16_t booster = _bMagicBoosters[_rank (s)];
-
-                // Find a magic for square 's' picking up an (almost) random number
-                // until we find the one that passes the verification test.
-                uint32_t i;
-
+                // Use Carry-Rippler trick to enumerate all subsets of masks_bb[s] and
+                // store the corresponding sliding attack bitboard in attacks_bb[s].
+                Bitboard occ = U64 (0);
                 do
                 {
-                    uint16_t index;
-                    do
-                    {
-                        magics_bb[s] = rkiss.rand_boost<Bitboard> (booster);
-                        index = (mask * magics_bb[s]) >> 0x38;
-                        //if (pop_count<MAX15> (index) >= 6) break;
-                    }
-                    while (pop_count<MAX15> (index) < 6);
+                    Bitboard &attacks = attacks_bb[s][indexer (s, occ)];
+                    Bitboard reference = attacks_sliding (s, deltas, occ);
 
-                    std::memset (attacks_bb[s], 0, size * sizeof (Bitboard));
+                    // A magic must map every occupancy to the correct sliding attack
+                    ASSERT (!attacks || attacks == reference);
+                    attacks = reference;
 
-                    // A good magic must map every possible occupancy to an index that
-                    // looks up the correct sliding attack in the attacks_bb[s] database.
-                    // Note that we build up the database for square 's' as a side
-                    // effect of verifying the magic.
-                    for (i = 0; i < size; ++i)
-                    {
-                        Bitboard &attacks = attacks_bb[s][indexer (s, occupancy[i])];
-
-                        if (attacks && (attacks != reference[i]))
-                        {
-                            break;
-                        }
-
-                        ASSERT (reference[i]);
-                        attacks = reference[i];
-                    }
+                    occ = (occ - mask) & mask;
                 }
-                while (i < size);
-
+                while (occ);
             }
         }
 
         void initialize_sliding ()
         {
-            initialize_table (BTable_bb, BAttack_bb, BMagic_bb, BMask_bb, BShift, _deltas_type[BSHP], indexer<BSHP>);
-            initialize_table (RTable_bb, RAttack_bb, RMagic_bb, RMask_bb, RShift, _deltas_type[ROOK], indexer<ROOK>);
+            initialize_table (BTable_bb, BAttack_bb, BMagic_bb, BMask_bb, BShift, _deltas_type[BSHP], BMagics, indexer<BSHP>);
+            initialize_table (RTable_bb, RAttack_bb, RMagic_bb, RMask_bb, RShift, _deltas_type[ROOK], RMagics, indexer<ROOK>);
         }
 
     }
@@ -559,6 +587,11 @@ namespace BitBoard {
 
         initialize_sliding ();
 
+        // The magic tables are always built, Sherwin and compact are derived from them
+        if      (SLD_KG      == SLIDER) initialize_kg ();
+        else if (SLD_SHERWIN == SLIDER) initialize_sherwin ();
+        else if (SLD_COMPACT == SLIDER) initialize_compact ();
+
         for (Square s1 = SQ_A1; s1 <= SQ_H8; ++s1)
         {
             for (Square s2 = SQ_A1; s2 <= SQ_H8; ++s2)
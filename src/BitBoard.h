@@ -4,6 +4,10 @@
 
 #include "Type.h"
 
+#ifdef BMI2
+#   include <immintrin.h> // _pext_u64()
+#endif
+
 namespace BitBoard {
 
 
@@ -79,6 +83,12 @@ namespace BitBoard {
     CACHE_ALIGN(64) extern Bitboard _attacks_pawn_bb[CLR_NO][SQ_NO];
     CACHE_ALIGN(64) extern Bitboard _attacks_type_bb[NONE][SQ_NO];
 
+    // Sizes of the sliding attack tables, summed over the squares
+    // 4 * 2^9 + 4 * 2^6 + 12 * 2^7 + 44 * 2^5 = 5248 = 0x1480
+    const uint32_t MAX_B_MOVES = U32 (0x1480);
+    // 4 * 2^12 + 24 * 2^11 + 36 * 2^10 = 102400 = 0x19000
+    const uint32_t MAX_R_MOVES = U32 (0x19000);
+
     CACHE_ALIGN(64) extern Bitboard*BAttack_bb[SQ_NO];
     CACHE_ALIGN(64) extern Bitboard*RAttack_bb[SQ_NO];
 
@@ -91,6 +101,42 @@ namespace BitBoard {
     CACHE_ALIGN(8) extern uint8_t      BShift[SQ_NO];
     CACHE_ALIGN(8) extern uint8_t      RShift[SQ_NO];
 
+    // Kindergarten tables (BitBoard.KG.cpp)
+    CACHE_ALIGN(64) extern Bitboard KGFillUp_bb[F_NO][SQ_NO];
+    CACHE_ALIGN(64) extern Bitboard KGFileA_bb [R_NO][SQ_NO];
+
+    // Sherwin tables (BitBoard.SHERWIN.cpp)
+    CACHE_ALIGN(64) extern uint32_t SWBRows[SQ_NO][6][0x040];
+    CACHE_ALIGN(64) extern uint32_t SWRRows[SQ_NO][8][0x100];
+    CACHE_ALIGN(64) extern Bitboard SWBTable_bb[MAX_B_MOVES];
+    CACHE_ALIGN(64) extern Bitboard SWRTable_bb[MAX_R_MOVES];
+
+    // Compact magic tables (BitBoard.COMPACT.cpp), the magic index selects a 16-bit
+    // reference to one of the distinct attack sets, a quarter of the magic tables size
+    CACHE_ALIGN(64) extern uint16_t*BAttack16[SQ_NO];
+    CACHE_ALIGN(64) extern uint16_t*RAttack16[SQ_NO];
+    CACHE_ALIGN(64) extern Bitboard BAttackSet_bb[];
+    CACHE_ALIGN(64) extern Bitboard RAttackSet_bb[];
+    extern uint16_t BAttackSets;
+    extern uint16_t RAttackSets;
+
+    // Sliding attacks backends, the one used by attacks_bb() is chosen at compile time
+    // - SLD_MAGIC   : Fancy magic bitboards, indexed with pext when built with BMI2
+    // - SLD_KG      : Kindergarten bitboards, small line tables shared by all squares
+    // - SLD_SHERWIN : Sherwin row lookups giving a dense index into per-square tables
+    // - SLD_COMPACT : Fancy magic index into 16-bit references to the distinct attack sets
+    typedef enum SliderT { SLD_MAGIC, SLD_KG, SLD_SHERWIN, SLD_COMPACT } SliderT;
+
+#if   defined(SLIDER_KG)
+    const SliderT SLIDER = SLD_KG;
+#elif defined(SLIDER_SHERWIN)
+    const SliderT SLIDER = SLD_SHERWIN;
+#elif defined(SLIDER_COMPACT)
+    const SliderT SLIDER = SLD_COMPACT;
+#else
+    const SliderT SLIDER = SLD_MAGIC;
+#endif
+
 
     inline Bitboard  operator&  (Bitboard  bb, Square s) { return bb &  _square_bb[s]; }
     inline Bitboard  operator|  (Bitboard  bb, Square s) { return bb |  _square_bb[s]; }
@@ -344,6 +390,8 @@ namespace BitBoard {
 
     template<PieceT PT>
     // Function 'indexer(s, occ)' for computing index for sliding attack bitboards.
+    // With BMI2 the index is the parallel bit extract of the occupancy under the mask,
+    // which is dense and collision free, so no magic multiply (nor magic) is needed.
     // Function 'attacks_bb(s, occ)' takes a square and a bitboard of occupied squares as input,
     // and returns a bitboard representing all squares attacked by PT (BISHOP or ROOK) on the given square.
     extern INLINE uint16_t indexer   (Square s, Bitboard occ);
@@ -352,7 +400,9 @@ namespace BitBoard {
     INLINE uint16_t indexer   <BSHP> (Square s, Bitboard occ)
     {
 
-#ifdef _64BIT
+#if defined(BMI2)
+        return uint16_t (_pext_u64 (occ, BMask_bb[s]));
+#elif defined(_64BIT)
         return uint16_t (((occ & BMask_bb[s]) * BMagic_bb[s]) >> BShift[s]);
 #else
         uint32_t lo = (uint32_t (occ >>  0) & uint32_t (BMask_bb[s] >>  0)) * uint32_t (BMagic_bb[s] >>  0);
@@ -366,7 +416,9 @@ namespace BitBoard {
     INLINE uint16_t indexer   <ROOK> (Square s, Bitboard occ)
     {
 
-#ifdef _64BIT
+#if defined(BMI2)
+        return uint16_t (_pext_u64 (occ, RMask_bb[s]));
+#elif defined(_64BIT)
         return uint16_t (((occ & RMask_bb[s]) * RMagic_bb[s]) >> RShift[s]);
 #else
         uint32_t lo = (uint32_t (occ >>  0) & uint32_t (RMask_bb[s] >>  0)) * uint32_t (RMagic_bb[s] >>  0);
@@ -376,19 +428,81 @@ namespace BitBoard {
 
     }
 
+    template<SliderT ST, PieceT PT>
+    // Function 'attacks_slider(s, occ)' gives the attacks of PT (BISHOP or ROOK) on square 's'
+    // with the given occupancy, looked up with the ST backend.
+    extern INLINE Bitboard attacks_slider (Square s, Bitboard occ);
+
+    template<>
+    INLINE Bitboard attacks_slider<SLD_MAGIC, BSHP> (Square s, Bitboard occ) { return BAttack_bb[s][indexer<BSHP> (s, occ)]; }
+    template<>
+    INLINE Bitboard attacks_slider<SLD_MAGIC, ROOK> (Square s, Bitboard occ) { return RAttack_bb[s][indexer<ROOK> (s, occ)]; }
+
+    template<>
+    // Multiplying by the B-file folds the diagonal blockers onto the 8th rank,
+    // so they index the first rank attacks filled up to all the ranks.
+    INLINE Bitboard attacks_slider<SLD_KG, BSHP> (Square s, Bitboard occ)
+    {
+        const Bitboard d18 = diag18_bb (s) - s;
+        const Bitboard d81 = diag81_bb (s) - s;
+        return (d18 & KGFillUp_bb[_file (s)][((d18 & occ) * U64 (0x0202020202020202)) >> 0x3A])
+            |  (d81 & KGFillUp_bb[_file (s)][((d81 & occ) * U64 (0x0202020202020202)) >> 0x3A]);
+    }
+    template<>
+    INLINE Bitboard attacks_slider<SLD_KG, ROOK> (Square s, Bitboard occ)
+    {
+        const Bitboard occ_f = (occ >> _file (s)) & U64 (0x0101010101010101); // on FILE-A
+        return ((rank_bb (s) - s) & KGFillUp_bb[_file (s)][(occ >> ((s & 0x38) + 1)) & 0x3F])
+            |  (KGFileA_bb[_rank (s)][(occ_f * U64 (0x0004081020408000)) >> 0x3A] << _file (s)); // DiagC7H2
+    }
+
+    template<>
+    // Each row of the blockers maps to its own bits of the index, the or of all
+    // the rows is the offset of the attacks of square 's' in the table.
+    INLINE Bitboard attacks_slider<SLD_SHERWIN, BSHP> (Square s, Bitboard occ)
+    {
+        const Bitboard mocc = (occ & BMask_bb[s]) >> 1;
+        return SWBTable_bb[
+              SWBRows[s][0][(mocc >>  8) & 0x3F]
+            | SWBRows[s][1][(mocc >> 16) & 0x3F]
+            | SWBRows[s][2][(mocc >> 24) & 0x3F]
+            | SWBRows[s][3][(mocc >> 32) & 0x3F]
+            | SWBRows[s][4][(mocc >> 40) & 0x3F]
+            | SWBRows[s][5][(mocc >> 48) & 0x3F]];
+    }
+    template<>
+    INLINE Bitboard attacks_slider<SLD_SHERWIN, ROOK> (Square s, Bitboard occ)
+    {
+        const Bitboard mocc = (occ & RMask_bb[s]);
+        return SWRTable_bb[
+              SWRRows[s][0][(mocc >>  0) & 0xFF]
+            | SWRRows[s][1][(mocc >>  8) & 0xFF]
+            | SWRRows[s][2][(mocc >> 16) & 0xFF]
+            | SWRRows[s][3][(mocc >> 24) & 0xFF]
+            | SWRRows[s][4][(mocc >> 32) & 0xFF]
+            | SWRRows[s][5][(mocc >> 40) & 0xFF]
+            | SWRRows[s][6][(mocc >> 48) & 0xFF]
+            | SWRRows[s][7][(mocc >> 56) & 0xFF]];
+    }
+
+    template<>
+    INLINE Bitboard attacks_slider<SLD_COMPACT, BSHP> (Square s, Bitboard occ) { return BAttackSet_bb[BAttack16[s][indexer<BSHP> (s, occ)]]; }
+    template<>
+    INLINE Bitboard attacks_slider<SLD_COMPACT, ROOK> (Square s, Bitboard occ) { return RAttackSet_bb[RAttack16[s][indexer<ROOK> (s, occ)]]; }
+
     template<>
     // Attacks of the BISHOP with occupancy
-    INLINE Bitboard attacks_bb<BSHP> (Square s, Bitboard occ) { return BAttack_bb[s][indexer<BSHP> (s, occ)]; }
+    INLINE Bitboard attacks_bb<BSHP> (Square s, Bitboard occ) { return attacks_slider<SLIDER, BSHP> (s, occ); }
     template<>
     // Attacks of the ROOK with occupancy
-    INLINE Bitboard attacks_bb<ROOK> (Square s, Bitboard occ) { return RAttack_bb[s][indexer<ROOK> (s, occ)]; }
+    INLINE Bitboard attacks_bb<ROOK> (Square s, Bitboard occ) { return attacks_slider<SLIDER, ROOK> (s, occ); }
     template<>
     // QUEEN Attacks with occ
     INLINE Bitboard attacks_bb<QUEN> (Square s, Bitboard occ)
     {
         return
-            BAttack_bb[s][indexer<BSHP> (s, occ)] |
-            RAttack_bb[s][indexer<ROOK> (s, occ)];
+            attacks_slider<SLIDER, BSHP> (s, occ) |
+            attacks_slider<SLIDER, ROOK> (s, occ);
     }
     // --------------------------------
 
@@ -411,6 +525,10 @@ namespace BitBoard {
 
     extern void initialize ();
 
+    extern void initialize_kg ();
+    extern void initialize_sherwin ();
+    extern void initialize_compact ();
+
     //extern Bitboard to_bitboard (const char s[], int32_t radix = 16);
     //extern Bitboard to_bitboard (const std::string &s, int32_t radix = 16);
 
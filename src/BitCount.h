@@ -90,7 +90,12 @@ INLINE uint8_t pop_count<CNT_HW_POPCNT> (Bitboard bb)
 #   ifdef _64BIT
 
 const BitCountT FULL  = CNT_64_FULL;
+#   ifdef DISPATCH
+// The compiler turns the full count into a single popcnt in the HOT_KERNEL clones
+const BitCountT MAX15 = CNT_64_FULL;
+#   else
 const BitCountT MAX15 = CNT_64_MAX15;
+#   endif
 
 const Bitboard M1_64 = U64 (0x5555555555555555);
 const Bitboard M2_64 = U64 (0x3333333333333333);
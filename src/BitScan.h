@@ -111,13 +111,13 @@ INLINE Square scan_msq (Bitboard bb)
 // Assembly code by Heinz van Saanen
 INLINE Square scan_lsq (Bitboard bb)
 {
-    uint8_t index;
+    Bitboard index; // bsfq needs a 64-bit destination register
     __asm__ ("bsfq %1, %0": "=r" (index) : "rm" (bb));
     return Square (index);
 }
 INLINE Square scan_msq (Bitboard bb)
 {
-    uint8_t index;
+    Bitboard index;
     __asm__ ("bsrq %1, %0": "=r" (index) : "rm" (bb));
     return Square (index);
 }
@@ -97,6 +97,9 @@ namespace EndGame {
         template<class M>
         inline void delete_endgame (const typename M::value_type &p) { delete p.second; }
 
+        template<class M>
+        inline bool less_key (const typename M::value_type &p1, const typename M::value_type &p2) { return p1.first < p2.first; }
+
     } // namespace
 
     // Endgames members definitions
@@ -120,6 +123,9 @@ namespace EndGame {
         add<KBPKN>   ("KBPKN");
         add<KBPPKB>  ("KBPPKB");
         add<KRPPKRP> ("KRPPKRP");
+
+        sort (m1.begin (), m1.end (), less_key<M1>);
+        sort (m2.begin (), m2.end (), less_key<M2>);
     }
 
     Endgames::~Endgames ()
@@ -131,8 +137,8 @@ namespace EndGame {
     template<EndgameT E>
     void Endgames::add (const string &code)
     {
-        map ((Endgame<E>*) 0)[key (code, WHITE)] = new Endgame<E> (WHITE);
-        map ((Endgame<E>*) 0)[key (code, BLACK)] = new Endgame<E> (BLACK);
+        map ((Endgame<E>*) 0).push_back (make_pair (key (code, WHITE), new Endgame<E> (WHITE)));
+        map ((Endgame<E>*) 0).push_back (make_pair (key (code, BLACK), new Endgame<E> (BLACK)));
     }
 
     template<>
@@ -2,7 +2,7 @@
 #ifndef ENDGAME_H_
 #define ENDGAME_H_
 
-#include <map>
+#include <vector>
 #include "Type.h"
 #include "Position.h"
 
@@ -84,20 +84,25 @@ namespace EndGame {
 
     };
 
-    // Endgames class stores in two std::map the pointers to endgame evaluation
-    // and scaling base objects. Then we use polymorphism to invoke the actual
-    // endgame function calling its operator() that is virtual.
+    // Endgames class stores in two flat arrays, sorted by material key, the pointers
+    // to endgame evaluation and scaling base objects. Then we use polymorphism to
+    // invoke the actual endgame function calling its operator() that is virtual.
+    // The arrays are filled once at startup and then only read, so a single
+    // instance is shared by all the threads.
     typedef class Endgames
     {
 
-        typedef std::map<Key, EndgameBase<eg_fun<0>::type>*> M1;
-        typedef std::map<Key, EndgameBase<eg_fun<1>::type>*> M2;
+        typedef EndgameBase<eg_fun<0>::type>* EF1;
+        typedef EndgameBase<eg_fun<1>::type>* EF2;
+
+        typedef std::vector<std::pair<Key, EF1> > M1;
+        typedef std::vector<std::pair<Key, EF2> > M2;
 
         M1 m1;
         M2 m2;
 
-        inline M1& map (M1::mapped_type) { return m1; }
-        inline M2& map (M2::mapped_type) { return m2; }
+        inline M1& map (EF1) { return m1; }
+        inline M2& map (EF2) { return m2; }
 
         template<EndgameT E>
         void add (const std::string &code);
@@ -108,9 +113,21 @@ namespace EndGame {
         ~Endgames ();
 
         template<class T>
+        // probe() binary searches the sorted keys, a few compares
+        // on a couple of cache lines instead of a tree walk.
         inline T probe (Key key, T &eg)
         {
-            return eg = (map (eg).count (key) ? map (eg)[key] : NULL);
+            const std::vector<std::pair<Key, T> > &m = map (eg);
+
+            uint32_t lo = 0;
+            uint32_t hi = m.size ();
+            while (lo < hi)
+            {
+                uint32_t mid = (lo + hi) / 2;
+                if (m[mid].first < key) lo = mid + 1;
+                else                    hi = mid;
+            }
+            return eg = (lo < m.size () && m[lo].first == key) ? m[lo].second : NULL;
         }
 
     } Endgames;
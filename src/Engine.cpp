@@ -2,9 +2,9 @@
 
 #include <sstream>
 #include <iomanip>
+#include "xstring.h"
 
 #include "BitBoard.h"
-#include "BitBases.h"
 #include "Pawns.h"
 #include "Material.h"
 #include "Evaluator.h"
@@ -34,6 +34,32 @@ namespace Engine {
 
         const string Months ("Jan Feb Mar Apr May Jun Jul Aug Sep Oct Nov Dec");
 
+        typedef void (*Initializer) ();
+
+        // Startup stage timings, reported with "--startup-profile"
+        ostringstream StartupProfile;
+
+        // msec_str() formats microseconds as milliseconds with 3 decimals
+        string msec_str (uint64_t usec)
+        {
+            ostringstream ss;
+            ss  << (usec / 1000) << "."
+                << setfill ('0') << setw (3) << (usec % 1000) << " ms";
+            return ss.str ();
+        }
+
+        // initialize_stage() runs one initializer and records its wall time
+        void initialize_stage (const char *name, Initializer initializer)
+        {
+            uint64_t time = system_time_usec ();
+            initializer ();
+            time = system_time_usec () - time;
+
+            StartupProfile << "info string Startup " << left << setw (10) << name << " " << msec_str (time) << "\n";
+        }
+
+        void initialize_threads () { Threads.initialize (); }
+
     }
 
     string info (bool uci)
@@ -86,29 +112,63 @@ namespace Engine {
 
     void run (const std::string &args)
     {
+        uint64_t startup_time = system_time_usec ();
+
+        // Flag "--startup-profile" reports the time spent to initialize the engine,
+        // the rest of the arguments is run as a command
+        string cmd = args;
+        bool startup_profile = (cmd.find ("--startup-profile") != string::npos);
+        if (startup_profile)
+        {
+            remove_substring (cmd, "--startup-profile");
+            trim (cmd);
+        }
+
         cout << Engine::info (false) << endl;
 
+#ifdef BMI2
+        if (!cpu_has_bmi2 ())
+        {
+            cerr << "ERROR: Built with BMI2 but this CPU has no BMI2 support, use a build without it." << endl;
+            ::exit (EXIT_FAILURE);
+        }
+#endif
+
         cout 
             << "info string " << cpu_count () << " processor(s) found."
 #ifdef POPCNT
             << " POPCNT available."
+#endif
+#ifdef BMI2
+            << " BMI2 available."
+#endif
+#ifdef DISPATCH
+            << (cpu_has_popcnt () ? " POPCNT kernels selected." : " Baseline kernels selected.")
 #endif
             << endl;
 
-        UCI      ::initialize ();
-        BitBoard ::initialize ();
-        Zobrist  ::initialize ();
-        Position ::initialize ();
-        BitBases ::initialize ();
-        Searcher ::initialize ();
-        Pawns    ::initialize ();
-        Evaluator::initialize ();
-        Threads   .initialize ();
+        initialize_stage ("UCI"      , UCI      ::initialize);
+        initialize_stage ("BitBoard" , BitBoard ::initialize);
+
+        initialize_stage ("Zobrist"  , Zobrist  ::initialize);
+        initialize_stage ("Position" , Position ::initialize);
+        initialize_stage ("Material" , Material ::initialize);
+        initialize_stage ("Searcher" , Searcher ::initialize);
+        initialize_stage ("Pawns"    , Pawns    ::initialize);
+        initialize_stage ("Evaluator", Evaluator::initialize);
+        initialize_stage ("Threads"  , initialize_threads);
 
         cout
             << "info string " << Threads.size () << " thread(s)." << "\n"
             << "info string " << TT.size ()      << " MB Hash."   << endl;
 
+        if (startup_profile)
+        {
+            cout
+                << StartupProfile.str ()
+                << "info string Startup " << left << setw (10) << "Total" << " " << msec_str (system_time_usec () - startup_time) << endl;
+        }
+
 #ifndef NDEBUG
         //Tester::main_test ();
         //system ("pause");
@@ -117,7 +177,7 @@ namespace Engine {
 
         //log_debug (true);
 
-        UCI   ::start (args);
+        UCI   ::start (cmd);
 
         //log_debug (false);
 
@@ -129,6 +189,7 @@ namespace Engine {
         UCI   ::stop ();
         if (Searcher::Book.is_open ()) Searcher::Book.close ();
         Threads.deinitialize ();
+        Material::deinitialize ();
         UCI   ::deinitialize ();
 
         ::exit (code);
@@ -1,6 +1,7 @@
 #include "Evaluator.h"
 
 #include <cassert>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
@@ -237,7 +238,7 @@ namespace {
     // scores, indexed by color and by a calculated integer number.
     Score KingDanger[CLR_NO][128];
 
-    template<bool TRACE>
+    template<bool TRACE, bool PROFILE>
     Value do_evaluate       (const Position &pos);
 
     template<Color C>
@@ -276,9 +277,32 @@ namespace {
 
     }
 
+    namespace Profiling {
+
+        // Evaluation stages timed while profiling
+        enum StageT
+        {
+            MATERIAL, PAWNS, ATTACKS, PIECES, KING_SAFETY, THREATS, PASSED_PAWNS, UNSTOPPABLE, SPACE_AREA, SCALING, TOTAL_EVAL, STAGE_NO
+        };
+
+        typedef struct Stat
+        {
+            uint64_t calls;
+            uint64_t ticks;
+        } Stat;
+
+        // One row of counters per thread, so no locking is needed while searching
+        Stat stats[MAX_THREADS][STAGE_NO];
+
+        void  record (uint8_t idx, StageT stage, uint64_t &ticks);
+        Value do_profile (const Position &pos);
+        string report ();
+
+    }
+
     // --------------
 
-    template<bool TRACE>
+    template<bool TRACE, bool PROFILE>
     inline Value do_evaluate       (const Position &pos)
     {
         ASSERT (!pos.checkers());
@@ -288,15 +312,19 @@ namespace {
 
         Thread *thread = pos.thread ();
 
+        uint64_t ticks = PROFILE ? cpu_ticks () : 0;
+
         // Initialize score by reading the incrementally updated scores included
         // in the position object (material + piece square tables) and adding Tempo bonus. 
         score = pos.psq_score () + (WHITE == pos.active () ? TempoBonus : -TempoBonus);
 
         EvalInfo ei;
         // Probe the material hash table
-        ei.mi = Material::probe (pos, thread->material_table, thread->endgames);
+        ei.mi = Material::probe (pos, thread->material_table);
         score += ei.mi->material_score ();
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::MATERIAL, ticks);
+
         // If we have a specialized evaluation function for the current material
         // configuration, call it and return.
         if (ei.mi->specialized_eval_exists ())
@@ -308,10 +336,14 @@ namespace {
         ei.pi = Pawns::probe (pos, thread->pawns_table);
         score += apply_weight (ei.pi->pawn_score(), Weights[PawnStructure]);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::PAWNS, ticks);
+
         // Initialize attack and king safety bitboards
         init_eval_info<WHITE> (pos, ei);
         init_eval_info<BLACK> (pos, ei);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::ATTACKS, ticks);
+
         Score mobility[CLR_NO] = { SCORE_ZERO, SCORE_ZERO };
 
         // Evaluate pieces and mobility
@@ -321,24 +353,34 @@ namespace {
         // Weight mobility
         score += apply_weight (mobility[WHITE] - mobility[BLACK], Weights[Mobility]);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::PIECES, ticks);
+
         // Evaluate kings after all other pieces because we need complete attack
         // information when computing the king safety evaluation.
         score += evaluate_king<WHITE, TRACE> (pos, ei)
             -    evaluate_king<BLACK, TRACE> (pos, ei);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::KING_SAFETY, ticks);
+
         // Evaluate tactical threats, we need full attack information including king
         score += evaluate_threats<WHITE, TRACE> (pos, ei)
             -    evaluate_threats<BLACK, TRACE> (pos, ei);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::THREATS, ticks);
+
         // Evaluate passed pawns, we need full attack information including king
         score += evaluate_passed_pawns<WHITE, TRACE> (pos, ei)
             -    evaluate_passed_pawns<BLACK, TRACE> (pos, ei);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::PASSED_PAWNS, ticks);
+
         // If one side has only a king, score for potential unstoppable pawns
         if (!pos.non_pawn_material (WHITE) || !pos.non_pawn_material (BLACK))
         {
             score += evaluate_unstoppable_pawns (pos, WHITE, ei)
                 -    evaluate_unstoppable_pawns (pos, BLACK, ei);
+
+            if (PROFILE) Profiling::record (thread->idx, Profiling::UNSTOPPABLE, ticks);
         }
 
         // Evaluate space for both sides, only in middle-game.
@@ -346,6 +388,8 @@ namespace {
         {
             int32_t scr = evaluate_space<WHITE> (pos, ei) - evaluate_space<BLACK> (pos, ei);
             score += apply_weight (scr * ei.mi->space_weight(), Weights[Space]);
+
+            if (PROFILE) Profiling::record (thread->idx, Profiling::SPACE_AREA, ticks);
         }
 
         // Scale winning side if position is more drawish than it appears
@@ -379,6 +423,8 @@ namespace {
 
         Value value = interpolate (score, ei.mi->game_phase (), sf);
 
+        if (PROFILE) Profiling::record (thread->idx, Profiling::SCALING, ticks);
+
         // In case of tracing add all single evaluation contributions for both white and black
         if (TRACE)
         {
@@ -1083,7 +1129,7 @@ namespace {
             stream << showpoint << showpos << setprecision (2) << fixed;
             std::memset (scores, 0, 2 * (TOTAL + 1) * sizeof (Score));
 
-            do_evaluate<true> (pos);
+            do_evaluate<true, false> (pos);
 
             string totals = stream.str ();
             stream.str ("");
@@ -1113,16 +1159,85 @@ namespace {
         }
     }
 
+    namespace Profiling {
+
+        // record() charges the ticks elapsed since 'ticks' to the given stage
+        // and restarts the measurement from now.
+        inline void record (uint8_t idx, StageT stage, uint64_t &ticks)
+        {
+            uint64_t cur_ticks = cpu_ticks ();
+            Stat &stat = stats[idx][stage];
+            ++stat.calls;
+            stat.ticks += cur_ticks - ticks;
+            ticks = cur_ticks;
+        }
+
+        Value do_profile (const Position &pos)
+        {
+            uint64_t ticks = cpu_ticks ();
+            Value value = do_evaluate<false, true> (pos);
+            record (pos.thread ()->idx, TOTAL_EVAL, ticks);
+            return value;
+        }
+
+        string report ()
+        {
+            const char *names[STAGE_NO] =
+            {
+                "Material probe", "Pawns probe", "Attack info", "Pieces, Mobility", "King safety",
+                "Threats", "Passed pawns", "Unstoppable pawns", "Space", "Scaling", "Total"
+            };
+
+            Stat total[STAGE_NO];
+            std::memset (total, 0, sizeof (total));
+            for (int32_t t = 0; t < MAX_THREADS; ++t)
+            {
+                for (int32_t st = 0; st < STAGE_NO; ++st)
+                {
+                    total[st].calls += stats[t][st].calls;
+                    total[st].ticks += stats[t][st].ticks;
+                }
+            }
+
+            ostringstream oss;
+            oss << setw (20)
+                << "Eval stage"     << " |        Calls |            Ticks |  Ticks/Call |   Share \n"
+                << "---------------------+--------------+------------------+-------------+---------\n";
+
+            oss << fixed << setprecision (1);
+            for (int32_t st = 0; st < STAGE_NO; ++st)
+            {
+                if (TOTAL_EVAL == st)
+                {
+                    oss << "---------------------+--------------+------------------+-------------+---------\n";
+                }
+
+                uint64_t calls = total[st].calls;
+                uint64_t ticks = total[st].ticks;
+                oss << setw (20) << names[st] << " | "
+                    << setw (12) << calls << " | "
+                    << setw (16) << ticks << " | "
+                    << setw (11) << (calls ? double (ticks) / calls : 0.0) << " | "
+                    << setw (6)  << (total[TOTAL_EVAL].ticks ? 100.0 * ticks / total[TOTAL_EVAL].ticks : 0.0) << "%\n";
+            }
+
+            return oss.str ();
+        }
+
+    }
+
 }
 
 namespace Evaluator {
 
+    bool Profile = false;
+
     // evaluate() is the main evaluation function. It always computes two
     // values, an endgame score and a middle game score, and interpolates
     // between them based on the remaining material.
-    Value evaluate  (const Position &pos)
+    HOT_KERNEL Value evaluate  (const Position &pos)
     {
-        return do_evaluate<false> (pos);
+        return Profile ? Profiling::do_profile (pos) : do_evaluate<false, false> (pos);
     }
 
     // trace() is like evaluate() but instead of a value returns a string suitable
@@ -1133,6 +1248,19 @@ namespace Evaluator {
         return Tracing::do_trace (pos);
     }
 
+    // reset_profile() clears the counters accumulated in profiling mode.
+    void reset_profile ()
+    {
+        std::memset (Profiling::stats, 0, sizeof (Profiling::stats));
+    }
+
+    // profile() returns the call counts and ticks spent in each evaluation
+    // stage, summed over all threads since the last reset_profile().
+    string profile  ()
+    {
+        return Profiling::report ();
+    }
+
     // initialize() computes evaluation weights from the corresponding UCI parameters
     // and setup king danger tables.
     void initialize ()
@@ -8,12 +8,19 @@ class Position;
 
 namespace Evaluator {
 
+    // When set, evaluate() accumulates per-stage call and tick counts
+    extern bool Profile;
+
     extern void initialize ();
 
     extern Value evaluate (const Position &pos);
 
     extern std::string trace (const Position &pos);
 
+    extern void reset_profile ();
+
+    extern std::string profile ();
+
 }
 
 #endif
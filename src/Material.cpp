@@ -4,6 +4,9 @@
 #include <cassert>
 #include <cstring>
 
+#include "Thread.h"
+#include "UCI.h"
+
 using namespace std;
 using namespace BitBoard;
 using namespace EndGame;
@@ -41,6 +44,9 @@ namespace {
         {   0,   0,   0,   0,   0,   0, }, // BP
     };
 
+    // Endgame functions keyed by material, shared read-only by all the threads
+    Endgames *EndgamesDB = NULL;
+
     // Endgame evaluation and scaling functions are accessed direcly and not through
     // the function maps because they correspond to more than one material hash key.
     Endgame<KXK>   EvaluateKXK  [CLR_NO] = { Endgame<KXK>    (WHITE), Endgame<KXK>    (BLACK) };
@@ -120,47 +126,32 @@ namespace {
         return value;
     }
 
-} // namespace
-
-namespace Material {
-
-    // Material::probe () takes a position object as input,
-    // looks up a MaterialEntry object, and returns a pointer to it.
-    // If the material configuration is not already present in the table,
-    // it is computed and stored there, so we don't have to recompute everything
-    // when the same material configuration occurs again.
-    Entry* probe     (const Position &pos, Table &table, Endgames &endgames)
+    // compute() fills the material entry for the material configuration of
+    // the given position.
+    void compute (const Position &pos, Material::Entry *e)
     {
-        Key key  = pos.matl_key ();
-        Entry *e = table[key];
-
-        // If e->_key matches the position's material hash key, it means that we
-        // have analysed this material configuration before, and we can simply
-        // return the information we found the last time instead of recomputing it.
-        if (e->_key == key) return e;
-
-        std::memset (e, 0, sizeof (Entry));
-        e->_key           = key;
+        std::memset (e, 0, sizeof (Material::Entry));
+        e->_key           = pos.matl_key ();
         e->_factor[WHITE] = e->_factor[BLACK] = SCALE_FACTOR_NORMAL;
-        e->_game_phase    = game_phase (pos);
+        e->_game_phase    = Material::game_phase (pos);
 
         // Let's look if we have a specialized evaluation function for this
         // particular material configuration. First we look for a fixed
         // configuration one, then a generic one if previous search failed.
-        if (endgames.probe (key, e->evaluation_func))
+        if (EndgamesDB->probe (e->_key, e->evaluation_func))
         {
-            return e;
+            return;
         }
 
         if (is_KXK<WHITE> (pos))
         {
             e->evaluation_func = &EvaluateKXK[WHITE];
-            return e;
+            return;
         }
         if (is_KXK<BLACK> (pos))
         {
             e->evaluation_func = &EvaluateKXK[BLACK];
-            return e;
+            return;
         }
 
         // OK, we didn't find any special evaluation function for the current
@@ -169,10 +160,10 @@ namespace Material {
         // We face problems when there are several conflicting applicable
         // scaling functions and we need to decide which one to use.
         EndgameBase<ScaleFactor> *eg_sf;
-        if (endgames.probe (key, eg_sf))
+        if (EndgamesDB->probe (e->_key, eg_sf))
         {
             e->scaling_func[eg_sf->color ()] = eg_sf;
-            return e;
+            return;
         }
 
         // Generic scaling functions that refer to more then one material distribution.
@@ -286,6 +277,208 @@ namespace Material {
         };
 
         e->_value = int16_t ((imbalance<WHITE> (count) - imbalance<BLACK> (count)) / 16);
+    }
+
+    // Shared read-only material table for the common configurations, indexed
+    // by piece counts: up to 8 pawns, 2 knights, 2 bishops (only as a pair on
+    // opposite colors), 2 rooks and 1 queen per side. NULL when not enabled.
+    const int32_t MaxCount[NONE] = { 8, 2, 2, 2, 1, 0, };
+
+    // Stride[c][pt] is the index step of one piece of color c and type pt
+    int32_t Stride[CLR_NO][NONE];
+    int32_t SharedSize;
+
+    // SharedTable is read by the search threads without any lock, so it is
+    // changed only by apply_shared(), when no search is running. The option
+    // builds the table into PendingTable and records the requested state.
+    Material::Entry *SharedTable  = NULL;
+    Material::Entry *PendingTable = NULL;
+    bool             SharedEnabled = false;
+
+    // shared_index() returns the index into the shared table of the material
+    // configuration of the position, or -1 if it is not covered by the table.
+    inline int32_t shared_index (const Position &pos)
+    {
+        int32_t idx = 0;
+        for (Color c = WHITE; c <= BLACK; ++c)
+        {
+            for (PieceT pt = PAWN; pt <= QUEN; ++pt)
+            {
+                int32_t n = pos.count (c, pt);
+                if (n > MaxCount[pt]) return -1;
+                idx += n * Stride[c][pt];
+            }
+            if (pos.count<BSHP> (c) == 2 && !pos.bishops_pair (c)) return -1;
+        }
+        return idx;
+    }
+
+    // shared_fen() forges a fen string with the material configuration of the
+    // given index, like the endgame key code does. Pieces stand on their initial
+    // squares (a single one on the queen side) and pawns on 2nd/7th rank.
+    string shared_fen (int32_t idx)
+    {
+        const PieceT Slots[F_NO] = { ROOK, NIHT, BSHP, QUEN, KING, BSHP, NIHT, ROOK };
+
+        string rows[CLR_NO][2]; // [color][pieces, pawns]
+        for (Color c = WHITE; c <= BLACK; ++c)
+        {
+            int32_t n[NONE];
+            int32_t placed[NONE] = { 0, 0, 0, 0, 0, 0, };
+            for (PieceT pt = PAWN; pt <= QUEN; ++pt)
+            {
+                n[pt] = (idx / Stride[c][pt]) % (MaxCount[pt] + 1);
+            }
+            n[KING] = 1;
+
+            for (File f = F_A; f <= F_H; ++f)
+            {
+                PieceT pt = Slots[f];
+                rows[c][0] += (placed[pt]++ < n[pt]) ? CharPiece[(c | pt)] : '1';
+                rows[c][1] += (f < n[PAWN]) ? CharPiece[(c | PAWN)] : '1';
+            }
+        }
+
+        string fen = rows[BLACK][0] + "/" + rows[BLACK][1] + "/8/8/8/8/"
+            +        rows[WHITE][1] + "/" + rows[WHITE][0];
+
+        // Merge the runs of empty squares
+        string merged;
+        for (uint32_t i = 0; i < fen.length (); ++i)
+        {
+            if ('1' == fen[i] && !merged.empty () && '1' <= *merged.rbegin () && *merged.rbegin () < '8')
+            {
+                ++(*merged.rbegin ());
+            }
+            else
+            {
+                merged += fen[i];
+            }
+        }
+
+        return merged + " w - - 0 1";
+    }
+
+    typedef struct BuildRange { Material::Entry *table; int32_t beg, end; } BuildRange;
+
+    // build_routine() is run by each of the threads building the shared table
+    extern "C" { inline void* build_routine (void *arg)
+    {
+        BuildRange *range = (BuildRange *) arg;
+        for (int32_t idx = range->beg; idx < range->end; ++idx)
+        {
+            compute (Position (shared_fen (idx)), &range->table[idx]);
+        }
+        return NULL;
+    } }
+
+} // namespace
+
+namespace Material {
+
+    // initialize() builds the shared endgame functions table. It needs the
+    // Zobrist keys, so must be called after Position::initialize().
+    void initialize ()
+    {
+        EndgamesDB = new Endgames ();
+
+        SharedSize = 1;
+        for (Color c = WHITE; c <= BLACK; ++c)
+        {
+            for (PieceT pt = PAWN; pt <= QUEN; ++pt)
+            {
+                Stride[c][pt] = SharedSize;
+                SharedSize   *= MaxCount[pt] + 1;
+            }
+        }
+
+        initialize_shared (bool (*(Options["Shared Material Table"])));
+        apply_shared ();
+    }
+
+    void deinitialize ()
+    {
+        initialize_shared (false);
+        apply_shared ();
+
+        delete EndgamesDB;
+        EndgamesDB = NULL;
+    }
+
+    // initialize_shared() enables or disables the shared material table,
+    // building it if needed by splitting the configurations among all the
+    // processors. A search may be running, so the change takes effect only
+    // at the next apply_shared().
+    void initialize_shared (bool enable)
+    {
+        SharedEnabled = enable;
+        if (!enable || SharedTable || PendingTable) return;
+
+        Entry *table = new Entry[SharedSize];
+
+        int32_t num_threads = max (1, min (cpu_count (), MAX_THREADS));
+        NativeHandle handles[MAX_THREADS];
+        BuildRange   ranges [MAX_THREADS];
+
+        for (int32_t t = 0; t < num_threads; ++t)
+        {
+            ranges[t].table = table;
+            ranges[t].beg   = SharedSize * (t + 0) / num_threads;
+            ranges[t].end   = SharedSize * (t + 1) / num_threads;
+            thread_create (handles[t], build_routine, &ranges[t]);
+        }
+        for (int32_t t = 0; t < num_threads; ++t)
+        {
+            thread_join (handles[t]);
+        }
+
+        PendingTable = table;
+    }
+
+    // apply_shared() publishes the pending shared table, or frees the tables
+    // if disabled. Must be called only when no search is running.
+    void apply_shared ()
+    {
+        if (SharedEnabled)
+        {
+            if (PendingTable)
+            {
+                SharedTable  = PendingTable;
+                PendingTable = NULL;
+            }
+        }
+        else
+        {
+            delete[] SharedTable;
+            delete[] PendingTable;
+            SharedTable  = NULL;
+            PendingTable = NULL;
+        }
+    }
+
+    // Material::probe () takes a position object as input,
+    // looks up a MaterialEntry object, and returns a pointer to it.
+    // Common configurations are read from the shared table when it is enabled.
+    // Otherwise if the material configuration is not already present in the table,
+    // it is computed and stored there, so we don't have to recompute everything
+    // when the same material configuration occurs again.
+    Entry* probe     (const Position &pos, Table &table)
+    {
+        if (SharedTable)
+        {
+            int32_t idx = shared_index (pos);
+            if (idx >= 0) return &SharedTable[idx];
+        }
+
+        Key key  = pos.matl_key ();
+        Entry *e = table[key];
+
+        // If e->_key matches the position's material hash key, it means that we
+        // have analysed this material configuration before, and we can simply
+        // return the information we found the last time instead of recomputing it.
+        if (e->_key == key) return e;
+
+        compute (pos, e);
         return e;
     }
 
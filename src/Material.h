@@ -55,7 +55,13 @@ namespace Material {
 
     typedef HashTable<Entry, 8192> Table;
 
-    Entry* probe     (const Position &pos, Table &table, EndGame::Endgames &endgames);
+    extern void   initialize ();
+    extern void deinitialize ();
+
+    extern void initialize_shared (bool enable);
+    extern void apply_shared ();
+
+    Entry* probe     (const Position &pos, Table &table);
     
     Phase game_phase (const Position &pos);
 
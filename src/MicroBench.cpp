@@ -0,0 +1,168 @@
+// MicroBench is a separate executable (Makefile target 'microbench') which times
+// the bitboard primitives in isolation, so that the effect of a compiler or a flag
+// change on them is seen directly, without the noise of a search.
+// The inputs are random but reproducible (RKISS with a fixed seed) and small
+// enough to stay in cache, the ops are independent so it measures throughput.
+// Usage: don-micro [millions of ops per primitive, default is 10] [seed]
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+#include "BitBoard.h"
+#include "BitCount.h"
+#include "BitScan.h"
+#include "BitRotate.h"
+#include "RKISS.h"
+#include "Time.h"
+
+using namespace std;
+
+namespace {
+
+    const uint16_t NUM_INPUT = 0x1000;
+
+    typedef struct Inputs
+    {
+        Bitboard occ[NUM_INPUT]; // About 8 occupied squares, as in a middle game
+        Bitboard any[NUM_INPUT]; // Full random words, never empty
+        Square   s1 [NUM_INPUT];
+        Square   s2 [NUM_INPUT];
+        int8_t   k  [NUM_INPUT]; // Rotations 1..63
+
+    } Inputs;
+
+    Inputs In;
+
+    // Keeps the timed ops from being optimized away
+    volatile Bitboard Sink;
+
+    INLINE Bitboard pop_lsq_of (Bitboard bb) { Square s = pop_lsq (bb); return bb ^ s; }
+
+    // PRIMITIVE defines a struct with the name and the op of a primitive
+    // on the i-th inputs, to be timed by measure<>().
+#define PRIMITIVE(P, NAME, EXPR)                                                        \
+    struct P                                                                            \
+    {                                                                                   \
+        static string name () { return NAME; }                                          \
+        static INLINE Bitboard op (uint16_t i) { return EXPR; }                         \
+    };
+
+    PRIMITIVE (PopCountFull , "pop_count<FULL>"   , pop_count<FULL > (In.any[i]))
+    PRIMITIVE (PopCountMax15, "pop_count<MAX15>"  , pop_count<MAX15> (In.occ[i] & U64 (0x00FF00FF00FF00FF)))
+    PRIMITIVE (ScanLsq      , "scan_lsq"          , scan_lsq (In.any[i]))
+    PRIMITIVE (ScanMsq      , "scan_msq"          , scan_msq (In.any[i]))
+    PRIMITIVE (PopLsq       , "pop_lsq"           , pop_lsq_of (In.any[i]))
+    PRIMITIVE (Between      , "betwen_sq_bb"      , BitBoard::betwen_sq_bb (In.s1[i], In.s2[i]))
+    PRIMITIVE (RotateL      , "rotate_L"          , rotate_L (In.any[i], In.k[i]))
+    PRIMITIVE (RotateR      , "rotate_R"          , rotate_R (In.any[i], In.k[i]))
+    PRIMITIVE (AttacksQuen  , "attacks_bb<QUEN>"  , BitBoard::attacks_bb<QUEN> (In.s1[i], In.occ[i]))
+    PRIMITIVE (RayBshp      , "ray walk<BSHP>"    , BitBoard::attacks_sliding (In.s1[i], BitBoard::_deltas_type[BSHP], In.occ[i]))
+    PRIMITIVE (RayRook      , "ray walk<ROOK>"    , BitBoard::attacks_sliding (In.s1[i], BitBoard::_deltas_type[ROOK], In.occ[i]))
+
+#undef PRIMITIVE
+
+    const char *SliderName[] = { "magic", "kg", "sherwin", "compact" };
+
+    template<BitBoard::SliderT ST, PieceT PT>
+    // Attacks<> is the primitive of the sliding attacks of one backend
+    struct Attacks
+    {
+        static string name () { return string (BSHP == PT ? "attacks<BSHP> " : "attacks<ROOK> ") + SliderName[ST]; }
+        static INLINE Bitboard op (uint16_t i) { return BitBoard::attacks_slider<ST, PT> (In.s1[i], In.occ[i]); }
+    };
+
+    template<class P>
+    // measure() prints the nanoseconds and the ticks per op of 'count' ops of P,
+    // with DISPATCH it runs the same clone as the engine kernels.
+    HOT_KERNEL void measure (uint32_t count)
+    {
+        Bitboard sink  = U64 (0);
+        uint64_t usec  = system_time_usec ();
+        uint64_t ticks = cpu_ticks ();
+        for (uint32_t n = 0; n < count; ++n)
+        {
+            sink ^= P::op (n & (NUM_INPUT - 1));
+        }
+        ticks = cpu_ticks () - ticks;
+        usec  = system_time_usec () - usec;
+        Sink  = sink;
+
+        cout<< left  << setw (24) << P::name ()
+            << right << fixed << setprecision (2)
+            << setw (8) << 1000.0 * usec / count << " ns/op"
+            << setw (8) << double (ticks) / count << " ticks/op" << endl;
+    }
+
+    template<BitBoard::SliderT ST>
+    void measure_slider (uint32_t count)
+    {
+        measure<Attacks<ST, BSHP> > (count);
+        measure<Attacks<ST, ROOK> > (count);
+    }
+
+    void initialize_inputs (uint32_t seed)
+    {
+        RKISS rkiss (seed);
+        for (uint16_t i = 0; i < NUM_INPUT; ++i)
+        {
+            In.occ[i] = rkiss.rand64 () & rkiss.rand64 () & rkiss.rand64 ();
+            do In.any[i] = rkiss.rand64 (); while (!In.any[i]);
+            In.s1[i]  = Square (rkiss.rand64 () & 0x3F);
+            In.s2[i]  = Square (rkiss.rand64 () & 0x3F);
+            In.k[i]   = int8_t (1 + rkiss.rand64 () % 63);
+        }
+    }
+
+}
+
+int main (int32_t argc, const char* const argv[])
+{
+    int32_t  millions = (argc > 1) ? max (1, atoi (argv[1])) : 10;
+    uint32_t seed     = (argc > 2) ? uint32_t (atoi (argv[2])) : 0x1234;
+    uint32_t count    = uint32_t (millions) * 1000000;
+
+    BitBoard::initialize ();
+    // Backends not selected at compile time are built on demand
+    BitBoard::initialize_kg ();
+    BitBoard::initialize_sherwin ();
+    BitBoard::initialize_compact ();
+
+    initialize_inputs (seed);
+
+    cout<< "Bitboard primitives: " << count << " ops each, seed " << seed << ", built with"
+#ifdef _64BIT
+        << " 64BIT"
+#endif
+#ifdef POPCNT
+        << " POPCNT"
+#endif
+#ifdef BSFQ
+        << " BSFQ"
+#endif
+#ifdef BMI2
+        << " BMI2"
+#endif
+#ifdef DISPATCH
+        << " DISPATCH"
+#endif
+        << ", slider " << SliderName[BitBoard::SLIDER] << "\n" << endl;
+
+    measure<PopCountFull > (count);
+    measure<PopCountMax15> (count);
+    measure<ScanLsq      > (count);
+    measure<ScanMsq      > (count);
+    measure<PopLsq       > (count);
+    measure<Between      > (count);
+    measure<RotateL      > (count);
+    measure<RotateR      > (count);
+    measure<AttacksQuen  > (count);
+    measure_slider<BitBoard::SLD_MAGIC  > (count);
+    measure_slider<BitBoard::SLD_KG     > (count);
+    measure_slider<BitBoard::SLD_SHERWIN> (count);
+    measure_slider<BitBoard::SLD_COMPACT> (count);
+    measure<RayBshp      > (count);
+    measure<RayRook      > (count);
+
+    return EXIT_SUCCESS;
+}
@@ -396,6 +396,220 @@ namespace MoveGenerator {
             return m_list;
         }
 
+        template<Delta D>
+        // Generates the queening and under-promotions of the pawns reaching the promotes squares.
+        INLINE void generate_legal_promotion (ValMove *&m_list, Bitboard promotes)
+        {
+            while (promotes)
+            {
+                Square dst = pop_lsq (promotes);
+                Square org = dst - D;
+
+                (m_list++)->move = mk_move<PROMOTE> (org, dst, QUEN);
+                (m_list++)->move = mk_move<PROMOTE> (org, dst, ROOK);
+                (m_list++)->move = mk_move<PROMOTE> (org, dst, BSHP);
+                (m_list++)->move = mk_move<PROMOTE> (org, dst, NIHT);
+            }
+        }
+
+        template<Color C>
+        // Generates the pawn pushes, captures and promotions of the given pawns
+        // whose destination is in the targets mask.
+        INLINE void generate_legal_pawns (ValMove *&m_list, const Position &pos, Bitboard pawns, Bitboard targets)
+        {
+            const Color C_   = ((WHITE == C) ? BLACK : WHITE);
+            const Delta PUSH = ((WHITE == C) ? DEL_N  : DEL_S);
+            const Delta RCAP = ((WHITE == C) ? DEL_NE : DEL_SW);
+            const Delta LCAP = ((WHITE == C) ? DEL_NW : DEL_SE);
+
+            Bitboard bbRR8 = rel_rank_bb (C, R_8);
+            Bitboard empties = ~pos.pieces ();
+            Bitboard enemies = pos.pieces (C_);
+
+            Bitboard push_1 = shift_del<PUSH> (pawns) & empties;
+            Bitboard push_2 = shift_del<PUSH> (push_1 & rel_rank_bb (C, R_3)) & empties & targets;
+            push_1 &= targets;
+            Bitboard attacksL = shift_del<LCAP> (pawns) & enemies & targets;
+            Bitboard attacksR = shift_del<RCAP> (pawns) & enemies & targets;
+
+            Bitboard promotes;
+            promotes = push_1   & bbRR8; push_1   &= ~promotes; generate_legal_promotion<PUSH> (m_list, promotes);
+            promotes = attacksL & bbRR8; attacksL &= ~promotes; generate_legal_promotion<LCAP> (m_list, promotes);
+            promotes = attacksR & bbRR8; attacksR &= ~promotes; generate_legal_promotion<RCAP> (m_list, promotes);
+
+            SERIALIZE_PAWNS (m_list, Delta (PUSH << 0), push_1);
+            SERIALIZE_PAWNS (m_list, Delta (PUSH << 1), push_2);
+            SERIALIZE_PAWNS (m_list, LCAP, attacksL);
+            SERIALIZE_PAWNS (m_list, RCAP, attacksR);
+        }
+
+        template<Color C, PieceT PT>
+        // Generates the moves of the pieces of type PT, a pinned piece moves
+        // only along the line through the king and itself.
+        INLINE void generate_legal_pieces (ValMove *&m_list, const Position &pos, Bitboard targets, Bitboard pinneds)
+        {
+            Square k_sq  = pos.king_sq (C);
+            Bitboard occ = pos.pieces ();
+
+            const Square *pl = pos.list<PT> (C);
+            Square s;
+            while ((s = *pl++) != SQ_NO)
+            {
+                Bitboard moves = attacks_bb<PT> (s, occ) & targets;
+                if (UNLIKELY (pinneds & s)) moves &= _lines_sq_bb[k_sq][s];
+
+                SERIALIZE (m_list, s, moves);
+            }
+        }
+
+        template<Color C>
+        // Generates only legal moves. The check mask (squares which capture or
+        // block the single checker) and the pin rays are computed once, and only
+        // the king moves and en-passant captures need an attack test each.
+        INLINE ValMove* generate_legal (ValMove *m_list, const Position &pos)
+        {
+            const Color C_   = ((WHITE == C) ? BLACK : WHITE);
+            const Delta PUSH = ((WHITE == C) ? DEL_N  : DEL_S);
+
+            Square k_sq      = pos.king_sq (C);
+            Bitboard occ     = pos.pieces ();
+            Bitboard friends = pos.pieces (C);
+            Bitboard enemies = pos.pieces (C_);
+            Bitboard checkers= pos.checkers ();
+
+            // King moves, with the king removed so that sliders see through it
+            Bitboard moves = attacks_bb<KING> (k_sq) & ~friends & ~attacks_bb<KING> (pos.king_sq (C_));
+            while (moves)
+            {
+                Square dst = pop_lsq (moves);
+                if (!(pos.attackers_to (dst, occ - k_sq) & enemies))
+                {
+                    (m_list++)->move = mk_move<NORMAL> (k_sq, dst);
+                }
+            }
+
+            // If double check, then only a king move can save the day
+            if (more_than_one (checkers)) return m_list;
+
+            Bitboard check_mask = checkers ?
+                betwen_sq_bb (scan_lsq (checkers), k_sq) | checkers : ~U64 (0);
+            Bitboard targets = ~friends & check_mask;
+            Bitboard pinneds = pos.pinneds (C);
+
+            Bitboard pawns   = pos.pieces<PAWN> (C);
+            generate_legal_pawns<C> (m_list, pos, pawns & ~pinneds, check_mask);
+            Bitboard pinned_pawns = pawns & pinneds;
+            while (pinned_pawns)
+            {
+                Square s = pop_lsq (pinned_pawns);
+                generate_legal_pawns<C> (m_list, pos, square_bb (s), check_mask & _lines_sq_bb[k_sq][s]);
+            }
+
+            generate_legal_pieces<C, NIHT> (m_list, pos, targets, pinneds);
+            generate_legal_pieces<C, BSHP> (m_list, pos, targets, pinneds);
+            generate_legal_pieces<C, ROOK> (m_list, pos, targets, pinneds);
+            generate_legal_pieces<C, QUEN> (m_list, pos, targets, pinneds);
+
+            // En-passant removes two pawns from the same rank, so test it
+            // directly on the resulting occupancy.
+            Square ep_sq = pos.en_passant ();
+            if (SQ_NO != ep_sq)
+            {
+                Square cap_sq = ep_sq - PUSH;
+                Bitboard pawns_ep = attacks_bb<PAWN> (C_, ep_sq) & pawns;
+                while (pawns_ep)
+                {
+                    Square org = pop_lsq (pawns_ep);
+                    Bitboard mocc = occ - org - cap_sq + ep_sq;
+                    if (!(pos.attackers_to (k_sq, mocc) & enemies & square_bb_ (cap_sq)))
+                    {
+                        (m_list++)->move = mk_move<ENPASSANT> (org, ep_sq);
+                    }
+                }
+            }
+
+            // Castling moves are generated only when legal
+            if (!checkers && !pos.castle_impeded (C) && pos.can_castle (C))
+            {
+                if (!pos.castle_impeded (C, CS_K) && pos.can_castle (C, CS_K))
+                {
+                    pos.chess960 () ?
+                        Generator<LEGAL, KING>::generate_castling<CS_K,  true> (m_list, pos, C, NULL) :
+                        Generator<LEGAL, KING>::generate_castling<CS_K, false> (m_list, pos, C, NULL);
+                }
+                if (!pos.castle_impeded (C, CS_Q) && pos.can_castle (C, CS_Q))
+                {
+                    pos.chess960 () ?
+                        Generator<LEGAL, KING>::generate_castling<CS_Q,  true> (m_list, pos, C, NULL) :
+                        Generator<LEGAL, KING>::generate_castling<CS_Q, false> (m_list, pos, C, NULL);
+                }
+            }
+
+            return m_list;
+        }
+
+        template<Color C>
+        // Generates the captures of the given enemy pieces, ordered by the attacker
+        // from pawns to king. Pawns on the 7th rank are left to the promotions.
+        INLINE ValMove* generate_captures (ValMove *m_list, const Position &pos, Bitboard targets, bool en_passant)
+        {
+            const Color C_   = ((WHITE == C) ? BLACK : WHITE);
+            const Delta RCAP = ((WHITE == C) ? DEL_NE : DEL_SW);
+            const Delta LCAP = ((WHITE == C) ? DEL_NW : DEL_SE);
+
+            Bitboard pawns_on_Rx = pos.pieces<PAWN> (C) & ~rel_rank_bb (C, R_7);
+            Bitboard attacksL = shift_del<LCAP> (pawns_on_Rx) & targets;
+            Bitboard attacksR = shift_del<RCAP> (pawns_on_Rx) & targets;
+
+            SERIALIZE_PAWNS (m_list, LCAP, attacksL);
+            SERIALIZE_PAWNS (m_list, RCAP, attacksR);
+
+            Square ep_sq = pos.en_passant ();
+            if (en_passant && SQ_NO != ep_sq)
+            {
+                Bitboard pawns_ep = attacks_bb<PAWN> (C_, ep_sq) & pawns_on_Rx;
+                while (pawns_ep)
+                {
+                    (m_list++)->move = mk_move<ENPASSANT> (pop_lsq (pawns_ep), ep_sq);
+                }
+            }
+
+            Generator<CAPTURE, NIHT>::generate (m_list, pos, C, targets);
+            Generator<CAPTURE, BSHP>::generate (m_list, pos, C, targets);
+            Generator<CAPTURE, ROOK>::generate (m_list, pos, C, targets);
+            Generator<CAPTURE, QUEN>::generate (m_list, pos, C, targets);
+            Generator<CAPTURE, KING>::generate (m_list, pos, C, targets);
+
+            return m_list;
+        }
+
+        template<Color C>
+        // Generates the capturing or the non-capturing queen promotions.
+        INLINE ValMove* generate_promotions (ValMove *m_list, const Position &pos, bool captures)
+        {
+            const Color C_   = ((WHITE == C) ? BLACK : WHITE);
+            const Delta PUSH = ((WHITE == C) ? DEL_N  : DEL_S);
+            const Delta RCAP = ((WHITE == C) ? DEL_NE : DEL_SW);
+            const Delta LCAP = ((WHITE == C) ? DEL_NW : DEL_SE);
+
+            Bitboard pawns_on_R7 = pos.pieces<PAWN> (C) & rel_rank_bb (C, R_7);
+            if (pawns_on_R7)
+            {
+                if (captures)
+                {
+                    Bitboard enemies = pos.pieces (C_);
+                    Generator<CAPTURE, PAWN>::generate_promotion<LCAP> (m_list, pawns_on_R7, enemies, NULL);
+                    Generator<CAPTURE, PAWN>::generate_promotion<RCAP> (m_list, pawns_on_R7, enemies, NULL);
+                }
+                else
+                {
+                    Generator<CAPTURE, PAWN>::generate_promotion<PUSH> (m_list, pawns_on_R7, ~pos.pieces (), NULL);
+                }
+            }
+
+            return m_list;
+        }
+
         //INLINE void filter_illegal (ValMove *beg, ValMove *&end, const Position &pos)
         //{
         //    Square k_sq = pos.king_sq (pos.active ());
@@ -426,7 +640,7 @@ namespace MoveGenerator {
 
     template<GenT GT>
     // Generates all pseudo-legal moves.
-    ValMove* generate (ValMove *m_list, const Position &pos)
+    HOT_KERNEL ValMove* generate (ValMove *m_list, const Position &pos)
     {
         //ASSERT (RELAX == GT || CAPTURE == GT || QUIET == GT);
         static_assert (RELAX == GT || CAPTURE == GT || QUIET == GT, "GT must be RELAX | CAPTURE | QUIET");
@@ -459,10 +673,48 @@ namespace MoveGenerator {
     template ValMove* generate<QUIET>   (ValMove *m_list, const Position &pos);
     // --------------------------------
 
+    // Generates the pseudo-legal captures of the enemy pieces of type victim,
+    // ordered by the least valuable attacker first, so that taken group by group
+    // from QUEN down to PAWN they come in MVV/LVA order with no scoring.
+    // With NONE generates the capturing queen promotions instead, and with QUEN
+    // the queen push-promotions follow the queen captures, as in MVV/LVA order
+    // they gain a queen less a pawn.
+    // Returns a pointer to the end of the move list.
+    HOT_KERNEL ValMove* generate_captures (ValMove *m_list, const Position &pos, PieceT victim)
+    {
+        ASSERT (!pos.checkers ());
+        ASSERT (PAWN <= victim && victim <= NONE && KING != victim);
+
+        Color active = pos.active ();
+
+        if (NONE == victim)
+        {
+            return WHITE == active ? generate_promotions<WHITE> (m_list, pos, true)
+                :  BLACK == active ? generate_promotions<BLACK> (m_list, pos, true)
+                :  m_list;
+        }
+
+        Bitboard targets = pos.pieces (~active, victim);
+        if (targets)
+        {
+            m_list = WHITE == active ? generate_captures<WHITE> (m_list, pos, targets, PAWN == victim)
+                :    BLACK == active ? generate_captures<BLACK> (m_list, pos, targets, PAWN == victim)
+                :    m_list;
+        }
+        if (QUEN == victim)
+        {
+            m_list = WHITE == active ? generate_promotions<WHITE> (m_list, pos, false)
+                :    BLACK == active ? generate_promotions<BLACK> (m_list, pos, false)
+                :    m_list;
+        }
+
+        return m_list;
+    }
+
     template<>
     // Generates all pseudo-legal non-captures and knight underpromotions moves that give check.
     // Returns a pointer to the end of the move list.
-    ValMove* generate<QUIET_CHECK> (ValMove *m_list, const Position &pos)
+    HOT_KERNEL ValMove* generate<QUIET_CHECK> (ValMove *m_list, const Position &pos)
     {
         ASSERT (!pos.checkers ());
 
@@ -493,7 +745,7 @@ namespace MoveGenerator {
     template<>
     // Generates all pseudo-legal check giving moves.
     // Returns a pointer to the end of the move list.
-    ValMove* generate<CHECK>       (ValMove *m_list, const Position &pos)
+    HOT_KERNEL ValMove* generate<CHECK>       (ValMove *m_list, const Position &pos)
     {
         Color active    = pos.active ();
         Bitboard targets= ~pos.pieces (active);
@@ -522,7 +774,7 @@ namespace MoveGenerator {
     template<>
     // Generates all pseudo-legal check evasions moves when the side to move is in check.
     // Returns a pointer to the end of the move list.
-    ValMove* generate<EVASION>     (ValMove *m_list, const Position &pos)
+    HOT_KERNEL ValMove* generate<EVASION>     (ValMove *m_list, const Position &pos)
     {
         Color active = pos.active ();
         Bitboard checkers = pos.checkers ();
@@ -594,31 +846,11 @@ namespace MoveGenerator {
 
     template<>
     // Generates all legal moves.
-    ValMove* generate<LEGAL>       (ValMove *m_list, const Position &pos)
+    HOT_KERNEL ValMove* generate<LEGAL>       (ValMove *m_list, const Position &pos)
     {
-        ValMove *end = pos.checkers() ?
-            generate<EVASION> (m_list, pos) :
-            generate<RELAX  > (m_list, pos) ;
-
-        Square k_sq = pos.king_sq (pos.active ());
-        Bitboard pinneds = pos.pinneds (pos.active ());
-
-        ValMove *cur = m_list;
-        while (cur != end)
-        {
-            Move m = cur->move;
-            if ((org_sq (m) == k_sq || pinneds || ENPASSANT == mtype (m)) &&
-                !pos.legal (m, pinneds))
-            {
-                cur->move = (--end)->move;
-            }
-            else
-            {
-                ++cur;
-            }
-        }
-
-        return end;
+        return WHITE == pos.active () ? generate_legal<WHITE> (m_list, pos)
+            :  BLACK == pos.active () ? generate_legal<BLACK> (m_list, pos)
+            :  m_list;
     }
 
 #undef SERIALIZE
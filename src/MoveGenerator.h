@@ -47,6 +47,8 @@ namespace MoveGenerator {
     template<GenT GT>
     extern ValMove* generate (ValMove *m_list, const Position &pos);
 
+    extern ValMove* generate_captures (ValMove *m_list, const Position &pos, PieceT victim);
+
     // The MoveList struct is a simple wrapper around generate(). It sometimes comes
     // in handy to use this class instead of the low level generate() function.
     template<GenT GT>
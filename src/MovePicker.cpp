@@ -5,12 +5,16 @@
 using namespace std;
 using namespace Searcher;
 using namespace MoveGenerator;
+using namespace BitBoard;
 
 namespace {
 
+    // History bonus is 1 << depth, beyond this depth all quiets are sorted
+    const Depth MAX_HISTORY_DEPTH = Depth (16 * ONE_PLY);
+
     enum StageT : uint8_t
     {
-        MAIN_STAGE,  CAPTURES_S1, KILLERS_S1, QUIETS_1_S1, QUIETS_2_S1, BAD_CAPTURES_S1,
+        MAIN_STAGE,  CAPTURES_S1, KILLERS_S1, QUIETS_S1, BAD_CAPTURES_S1,
         EVASIONS,    EVASIONS_S2,
         QSEARCH_0,   CAPTURES_S3, QUIET_CHECKS_S3,
         QSEARCH_1,   CAPTURES_S4,
@@ -34,6 +38,28 @@ namespace {
         }
     }
 
+    // Sorts in descending order only the moves with value >= limit, moving them
+    // to the front, and leaves the rest unsorted after them. Equal values keep
+    // their generation order, as with insertion_sort().
+    inline void partial_insertion_sort (ValMove *beg, ValMove *end, Value limit)
+    {
+        for (ValMove *sorted_end = beg, *p = beg; p < end; ++p)
+        {
+            if (p->value >= limit)
+            {
+                ValMove tmp = *p;
+                *p = *sorted_end;
+                ValMove *q;
+                for (q = sorted_end; q != beg && *(q-1) < tmp; --q)
+                {
+                    *q = *(q-1);
+                }
+                *q = tmp;
+                ++sorted_end;
+            }
+        }
+    }
+
     // Picks and moves to the front the best move in the range [beg, end),
     // it is faster than sorting all the moves in advance when moves are few, as
     // normally are the possible captures.
@@ -53,13 +79,17 @@ namespace {
 MovePicker::MovePicker (const Position &p, Move ttm, Depth d, const HistoryStats &h, Move cm[], Move fm[], Stack s[])
     : pos (p)
     , history (h)
-    , depth (d)
+    , ss (s)
     , counter_moves (cm)
     , followup_moves (fm)
-    , ss (s)
+    , depth (d)
+    , m_list (p.thread ()->move_stack_top)
     , cur (m_list)
     , end (m_list)
+    , generated (0)
+    , picked (0)
 {
+    carve ();
     ASSERT (d > DEPTH_ZERO);
 
     end_bad_captures = m_list + MAX_MOVES - 1;
@@ -73,9 +103,13 @@ MovePicker::MovePicker (const Position &p, Move ttm, Depth d, const HistoryStats
 MovePicker::MovePicker (const Position &p, Move ttm, Depth d, const HistoryStats &h, Square sq)
     : pos (p)
     , history (h)
+    , m_list (p.thread ()->move_stack_top)
     , cur (m_list)
     , end (m_list)
+    , generated (0)
+    , picked (0)
 {
+    carve ();
     ASSERT (d <= DEPTH_ZERO);
 
     if (pos.checkers ())
@@ -112,9 +146,13 @@ MovePicker::MovePicker (const Position &p, Move ttm, Depth d, const HistoryStats
 MovePicker::MovePicker (const Position &p, Move ttm,          const HistoryStats &h, PieceT pt)
     : pos (p)
     , history (h)
+    , m_list (p.thread ()->move_stack_top)
     , cur (m_list)
     , end (m_list)
+    , generated (0)
+    , picked (0)
 {
+    carve ();
     ASSERT (!pos.checkers ());
 
     stage = PROBCUT;
@@ -123,7 +161,7 @@ MovePicker::MovePicker (const Position &p, Move ttm,          const HistoryStats
     capture_threshold = PieceValue[MG][pt];
 
     tt_move = (ttm && pos.pseudo_legal (ttm) ? ttm : MOVE_NONE);
-    if (tt_move && (!pos.capture (tt_move) || pos.see (tt_move) <= capture_threshold))
+    if (tt_move && (!pos.capture (tt_move) || !pos.see_ge (tt_move, capture_threshold + 1)))
     {
         tt_move = MOVE_NONE;
     }
@@ -131,43 +169,25 @@ MovePicker::MovePicker (const Position &p, Move ttm,          const HistoryStats
 }
 
 
-// value() assign a numerical move ordering score to each move in a move list.
-// The moves with highest scores will be picked first.
-
-template<>
-void MovePicker::value<CAPTURE> ()
+// The move list goes back to the thread's move stack. MovePickers are created
+// and destroyed in stack order on each thread, also at split points where the
+// slaves only pick from the master's one.
+MovePicker::~MovePicker ()
 {
-    // Winning and equal captures in the main search are ordered by MVV/LVA.
-    // Suprisingly, this appears to perform slightly better than SEE based
-    // move ordering. The reason is probably that in a position with a winning
-    // capture, capturing a more valuable (but sufficiently defended) piece
-    // first usually doesn't hurt. The opponent will have to recapture, and
-    // the hanging piece will still be hanging (except in the unusual cases
-    // where it is possible to recapture with the hanging piece). Exchanging
-    // big pieces before capturing a hanging piece probably helps to reduce
-    // the subtree size.
-    // In main search we want to push captures with negative SEE values to
-    // bad_captures[] array, but instead of doing it now we delay till when
-    // the move has been picked up in pick_move(), this way we save
-    // some SEE calls in case we get a cutoff (idea from Pablo Vazquez).
-    for (ValMove *itr = m_list; itr != end; ++itr)
-    {
-        Move m = itr->move;
-        itr->value = PieceValue[MG][_ptype (pos[dst_sq (m)])] - _ptype (pos[org_sq (m)]);
+    pos.thread ()->move_stack_top = m_list;
+}
 
-        switch (mtype (m))
-        {
-        case PROMOTE:
-            itr->value += PieceValue[MG][prom_type (m)]
-            - PieceValue[MG][PAWN];
-            break;
-        case ENPASSANT:
-            itr->value += PieceValue[MG][PAWN];
-            break;
-        }
-    }
+// carve() reserves the move list on top of the thread's move stack.
+void MovePicker::carve ()
+{
+    Thread *thread = pos.thread ();
+    ASSERT (m_list + MAX_MOVES <= thread->move_stack + MAX_MOVE_STACK);
+    thread->move_stack_top = m_list + MAX_MOVES;
 }
 
+// value() assign a numerical move ordering score to each move in a move list.
+// The moves with highest scores will be picked first.
+
 template<>
 void MovePicker::value<QUIET>   ()
 {
@@ -184,10 +204,17 @@ void MovePicker::value<EVASION> ()
     // Try good captures ordered by MVV/LVA, then non-captures if destination square
     // is not under attack, ordered by history value, then bad-captures and quiet
     // moves with a negative SEE. This last group is ordered by the SEE value.
+    // The captures of a single checker all go to its square, so their SEE
+    // values are computed together first.
+    Bitboard checkers = pos.checkers ();
+    Square check_sq = more_than_one (checkers) ? SQ_NO : scan_lsq (checkers);
+    if (SQ_NO != check_sq) pos.see_batch (check_sq, m_list, end);
+
     for (ValMove *itr = m_list; itr != end; ++itr)
     {
         Move m = itr->move;
-        int32_t gain = pos.see_sign (m);
+        int32_t gain = (dst_sq (m) == check_sq && ENPASSANT != mtype (m))
+            ? int32_t (itr->value) : pos.see_sign (m);
         if (gain < 0)
         {
             itr->value = gain - VALUE_KNOWN_WIN; // At the bottom
@@ -204,11 +231,62 @@ void MovePicker::value<EVASION> ()
     }
 }
 
+// generate_next_captures() generates the next non-empty group of captures,
+// returns false when all the groups are done.
+// Captures come grouped by victim, the capturing queen promotions first and
+// then the captures of queens down to pawns, each group ordered by the least
+// valuable attacker, which is the MVV/LVA order. Suprisingly, this appears to
+// perform slightly better than SEE based move ordering. The reason is probably
+// that in a position with a winning capture, capturing a more valuable (but
+// sufficiently defended) piece first usually doesn't hurt. The opponent will
+// have to recapture, and the hanging piece will still be hanging (except in
+// the unusual cases where it is possible to recapture with the hanging piece).
+// Exchanging big pieces before capturing a hanging piece probably helps to
+// reduce the subtree size.
+// The queen push-promotions close the queen group, as they gain a queen less
+// a pawn. As the moves come already ordered there is no scoring nor selection,
+// and the later groups are not generated at all if an earlier move cuts off.
+bool MovePicker::generate_next_captures ()
+{
+    while (victim >= PAWN)
+    {
+        PieceT pt = PieceT (victim);
+        victim = (NONE == pt) ? QUEN : victim - 1;
+
+        // Recaptures are all on one square, skip the other victims
+        if (   CAPTURES_S6 == stage && NONE != pt
+            && _ptype (pos[recapture_sq]) != pt)
+        {
+            continue;
+        }
+
+        end = generate_captures (m_list, pos, pt);
+        if (end > cur)
+        {
+            generated += uint16_t (end - cur);
+            return true;
+        }
+    }
+    return false;
+}
+
 // generate_next_stage () generates, scores and sorts the next bunch of moves,
 // when there are no more moves to try for the current phase.
 void MovePicker::generate_next_stage ()
 {
     cur = m_list;
+
+    switch (stage)
+    {
+    case CAPTURES_S1:
+    case CAPTURES_S3:
+    case CAPTURES_S4:
+    case CAPTURES_S5:
+    case CAPTURES_S6:
+        if (generate_next_captures ()) return;
+        break;
+    }
+
     switch (++stage)
     {
 
@@ -217,12 +295,13 @@ void MovePicker::generate_next_stage ()
     case CAPTURES_S4:
     case CAPTURES_S5:
     case CAPTURES_S6:
-        end = generate<CAPTURE> (m_list, pos);
-        if (end > cur + 1)
-        {   
-            value<CAPTURE> ();
-            insertion_sort  (cur, end);
-        }
+        // In main search we want to push captures with negative SEE values to
+        // bad_captures[] array, but instead of doing it now we delay till when
+        // the move has been picked up in pick_move(), this way we save
+        // some SEE calls in case we get a cutoff (idea from Pablo Vazquez).
+        victim = NONE;
+        end = cur;
+        generate_next_captures ();
 
         return;
 
@@ -287,22 +366,21 @@ void MovePicker::generate_next_stage ()
 
         return;
 
-    case QUIETS_1_S1:
-        end = end_quiets = generate<QUIET> (m_list, pos);
-        if (end > cur)
+    case QUIETS_S1:
+        // Only reached when the killers did not cut off, so quiets are
+        // scored lazily. Those with a history value above the limit are
+        // sorted to the front, the limit dropping with depth since a good
+        // ordering pays off more in bigger subtrees, the rest come unsorted.
+        end = generate<QUIET> (m_list, pos);
+        generated += uint16_t (end - cur);
+        if (end > cur + 1)
         {
-            value<QUIET> ();
-            end = partition (cur, end, ValMove ());
-            insertion_sort  (cur, end);
-        }
-        return;
+            Value limit =
+                depth < 3 * ONE_MOVE      ? Value (1) :
+                depth < MAX_HISTORY_DEPTH ? Value (-(1 << depth)) : -VALUE_INFINITE;
 
-    case QUIETS_2_S1:
-        cur = end;
-        end = end_quiets;
-        if (depth >= 3 * ONE_MOVE)
-        {
-            insertion_sort (cur, end);
+            value<QUIET> ();
+            partial_insertion_sort (cur, end, limit);
         }
 
         return;
@@ -316,6 +394,7 @@ void MovePicker::generate_next_stage ()
 
     case EVASIONS_S2:
         end = generate<EVASION> (m_list, pos);
+        generated += uint16_t (end - cur);
         if (end > cur + 1)
         {
             value<EVASION> ();
@@ -326,6 +405,7 @@ void MovePicker::generate_next_stage ()
 
     case QUIET_CHECKS_S3:
         end = generate<QUIET_CHECK> (m_list, pos);
+        generated += uint16_t (end - cur);
 
         return;
 
@@ -346,12 +426,9 @@ void MovePicker::generate_next_stage ()
     }
 }
 
-template<>
-// next_move() is the most important method of the MovePicker class. It returns
-// a new pseudo legal move every time is called, until there are no more moves
-// left. It picks the move with the biggest score from a list of generated moves
-// taking care not to return the tt_move if has already been searched previously.
-Move MovePicker::next_move<false> ()
+// pick_move() picks the move with the biggest score from a list of generated
+// moves taking care not to return the tt_move if has already been searched previously.
+Move MovePicker::pick_move ()
 {
     while (true) // (stage <= STOP)
     {
@@ -375,10 +452,10 @@ Move MovePicker::next_move<false> ()
         case CAPTURES_S1:
             do
             {
-                move = pick_best (cur++, end)->move;
+                move = (cur++)->move;
                 if (move != tt_move)
                 {
-                    if (pos.see_sign (move) >= 0) return move;
+                    if (pos.see_ge (move, 0)) return move;
                     // Losing capture, move it to the tail of the array
                     (end_bad_captures--)->move = move;
                 }
@@ -401,7 +478,7 @@ Move MovePicker::next_move<false> ()
             while (cur < end);
             break;
 
-        case QUIETS_1_S1: case QUIETS_2_S1:
+        case QUIETS_S1:
             do
             {
                 move = (cur++)->move;
@@ -422,7 +499,7 @@ Move MovePicker::next_move<false> ()
         case BAD_CAPTURES_S1:
             return (cur--)->move;
 
-        case EVASIONS_S2: case CAPTURES_S3: case CAPTURES_S4:
+        case EVASIONS_S2:
             do
             {
                 move = pick_best (cur++, end)->move;
@@ -434,11 +511,23 @@ Move MovePicker::next_move<false> ()
             while (cur < end);
             break;
 
+        case CAPTURES_S3: case CAPTURES_S4:
+            do
+            {
+                move = (cur++)->move;
+                if (move != tt_move)
+                {
+                    return move;
+                }
+            }
+            while (cur < end);
+            break;
+
         case CAPTURES_S5:
             do
             {
-                move = pick_best (cur++, end)->move;
-                if (move != tt_move && pos.see (move) > capture_threshold)
+                move = (cur++)->move;
+                if (move != tt_move && pos.see_ge (move, capture_threshold + 1))
                 {
                     return move;
                 }
@@ -449,7 +538,7 @@ Move MovePicker::next_move<false> ()
         case CAPTURES_S6:
             do
             {
-                move = pick_best (cur++, end)->move;
+                move = (cur++)->move;
                 if (dst_sq (move) == recapture_sq)
                 {
                     return move;
@@ -479,6 +568,17 @@ Move MovePicker::next_move<false> ()
     }
 }
 
+template<>
+// next_move() is the most important method of the MovePicker class. It returns
+// a new pseudo legal move every time is called, until there are no more moves
+// left.
+Move MovePicker::next_move<false> ()
+{
+    Move move = pick_move ();
+    picked += (move != MOVE_NONE);
+    return move;
+}
+
 template<>
 // Version of next_move() to use at split point nodes where the move is grabbed
 // from the split point's shared MovePicker object. This function is not thread
@@ -83,6 +83,12 @@ private:
 
     void generate_next_stage ();
 
+    bool generate_next_captures ();
+
+    Move pick_move ();
+
+    void carve ();
+
     const Position     &pos;
 
     const HistoryStats &history;
@@ -100,13 +106,18 @@ private:
     int32_t             capture_threshold;
 
     uint8_t             stage;
+    // Victim type of the next group of captures, NONE for the capturing promotions
+    int8_t              victim;
 
-    ValMove             m_list[MAX_MOVES];
+    ValMove            *m_list; // Carved from the thread's move stack
     ValMove            *cur
         ,              *end
-        ,              *end_quiets
         ,              *end_bad_captures;
 
+    // Moves generated and moves handed out by next_move(), for profiling
+    uint16_t            generated
+        ,               picked;
+
     MovePicker& operator= (const MovePicker &); // Silence a warning under MSVC
 
 public:
@@ -115,9 +126,14 @@ public:
     MovePicker (const Position &, Move, Depth, const HistoryStats &, Square);
     MovePicker (const Position &, Move, Depth, const HistoryStats &, Move[], Move[], Searcher::Stack[]);
 
+   ~MovePicker ();
+
     template<bool SpNode>
     Move next_move ();
 
+    uint16_t generated_count () const { return generated; }
+    uint16_t picked_count    () const { return picked; }
+
 };
 
 #endif
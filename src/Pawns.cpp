@@ -66,9 +66,31 @@ namespace {
     //    { S(0, 0), S(14, 0), S(16, 4), S(18,  9), S(28, 28), S(52, 104), S(118, 236) }, };
     Score Connected[F_NO][R_NO];
 
+    // Lookup tables indexed by the 8-bit file occupancy of one color's pawns
+    // (bit f is set if there is a pawn on file f), initialized by formula.
+    // IsolatedFiles[files] contains the files whose pawns have no friendly
+    // pawn on an adjacent file.
+    uint8_t IsolatedFiles[0x100];
+    // FileSpanBonus[files] contains the bonus for file distance of the two outermost pawns
+    Score   FileSpanBonus[0x100];
+
+    // ShelterStorm[shelter rank][storm rank] contains the combined shelter
+    // weakness and storm danger for one file, indexed by relative rank of our
+    // backmost pawn and of the enemy frontmost pawn (R_1 if none).
+    Value   ShelterStorm[R_NO][R_NO];
+
 #undef S
 #undef V
 
+    // file_mask() collapses a bitboard of pawns to the 8-bit set of occupied files
+    inline uint8_t file_mask (Bitboard b)
+    {
+        b |= b >> 0x20;
+        b |= b >> 0x10;
+        b |= b >> 0x08;
+        return uint8_t (b & 0xFF);
+    }
+
     template<Color C>
     inline Score evaluate (const Position &pos, Pawns::Entry *e)
     {
@@ -83,9 +105,11 @@ namespace {
             pos.pieces (C_, PAWN),
         };
 
+        const uint8_t files = file_mask (pawns[0]);
+
         e->_passed_pawns  [C] = e->_candidate_pawns[C] = 0;
         e->_king_sq       [C] = SQ_NO;
-        e->_semiopen_files[C] = 0xFF;
+        e->_semiopen_files[C] = uint8_t (~files);
         e->_pawn_attacks  [C] = shift_del<RCAP> (pawns[0]) | shift_del<LCAP> (pawns[0]);
         e->_pawn_count_sq [C][BLACK] = pop_count<MAX15> (pawns[0] & DARK_bb);
         e->_pawn_count_sq [C][WHITE] = pos.count<PAWN> (C) - e->_pawn_count_sq[C][BLACK];
@@ -102,15 +126,12 @@ namespace {
             File f = _file (s);
             Rank r = rel_rank (C, s);
 
-            // This file cannot be semi-open
-            e->_semiopen_files[C] &= ~(1 << f);
-
             // Our rank plus previous one, for connected pawn detection
             Bitboard rr_bb = rank_bb (s) | rank_bb (s - PUSH);
 
             // Flag the pawn as passed, isolated, doubled or connected (but not the backward one).
             bool connected=   pawns[0] & adj_files_bb (f) & rr_bb;
-            bool isolated = !(pawns[0] & adj_files_bb (f));
+            bool isolated =   IsolatedFiles[files] & (1 << f);
             bool doubled  =   pawns[0] & front_squares_bb (C, s);
             bool opposed  =   pawns[1] & front_squares_bb (C, s);
             bool passed   = !(pawns[1] & passer_pawn_span_bb (C, s));
@@ -175,11 +196,7 @@ namespace {
 
         // In endgame it's better to have pawns on both wings. So give a bonus according
         // to file distance between left and right outermost pawns.
-        if (pos.count<PAWN> (C) > 1)
-        {
-            Bitboard b = e->_semiopen_files[C] ^ 0xFF;
-            pawn_score += PawnsFileSpan * int32_t (scan_msq (b) - scan_lsq (b));
-        }
+        pawn_score += FileSpanBonus[files];
 
         return pawn_score;
     }
@@ -201,6 +218,26 @@ namespace Pawns {
                 Connected[f][r] = mk_score (bonus, bonus);
             }
         }
+
+        for (int32_t files = 0; files < 0x100; ++files)
+        {
+            // Adjacent files of the occupied ones
+            uint8_t adj_files = uint8_t ((files << 1) | (files >> 1));
+            IsolatedFiles[files] = files & ~adj_files;
+
+            FileSpanBonus[files] = files
+                ? PawnsFileSpan * int32_t (scan_msq (Bitboard (files)) - scan_lsq (Bitboard (files)))
+                : SCORE_ZERO;
+        }
+
+        for (Rank w_rk = R_1; w_rk <= R_8; ++w_rk)
+        {
+            for (Rank b_rk = R_1; b_rk <= R_8; ++b_rk)
+            {
+                int8_t danger = (w_rk != R_1) ? ((b_rk == w_rk + 1) ? 2 : 1) : 0;
+                ShelterStorm[w_rk][b_rk] = ShelterWeakness[w_rk] + StormDanger[danger][b_rk];
+            }
+        }
     }
 
     // probe() takes a position object as input, computes a Entry object, and returns
@@ -233,14 +270,18 @@ namespace Pawns {
             front_pawns & pos.pieces (C ),
             front_pawns & pos.pieces (C_),
         };
+        // Files with pawns, to skip scanning the empty ones
+        const uint8_t files[CLR_NO] =
+        {
+            file_mask (pawns[0]),
+            file_mask (pawns[1]),
+        };
 
         File kf = max (F_B, min (F_G, _file (k_sq)));
         for (File f = kf - 1; f <= kf + 1; ++f)
         {
-            Bitboard mid_pawns;
-
-            mid_pawns  = pawns[1] & file_bb (f);
-            Rank b_rk = mid_pawns ? rel_rank (C, scan_rel_frntmost_sq (C_, mid_pawns)) : R_1;
+            Rank b_rk = (files[1] & (1 << f))
+                ? rel_rank (C, scan_rel_frntmost_sq (C_, pawns[1] & file_bb (f))) : R_1;
 
             if ((MID_EDGE_bb & (f | b_rk)) &&
                 _file (k_sq) == f &&
@@ -250,11 +291,9 @@ namespace Pawns {
             }
             else
             {
-                mid_pawns = pawns[0] & file_bb (f);
-                Rank w_rk = mid_pawns ? rel_rank (C, scan_rel_backmost_sq (C , mid_pawns)) : R_1;
-                int8_t danger = (w_rk != R_1) ? ((b_rk == w_rk + 1) ? 2 : 1) : 0;
-                safety -= ShelterWeakness[w_rk]
-                +         StormDanger[danger][b_rk];
+                Rank w_rk = (files[0] & (1 << f))
+                    ? rel_rank (C, scan_rel_backmost_sq (C , pawns[0] & file_bb (f))) : R_1;
+                safety -= ShelterStorm[w_rk][b_rk];
             }
         }
 
@@ -144,6 +144,20 @@ typedef unsigned long long      uint64_t;
 
 #endif
 
+// DISPATCH builds one portable binary with the hot kernels (evaluation and move
+// generation) cloned for the popcnt and the baseline ISA, the dynamic loader picks
+// the clone matching the CPU (GCC ifunc). Elsewhere it has no effect.
+// The callees are flattened into each clone, else they would run the baseline code.
+#if defined(DISPATCH) && !(defined(__GNUC__) && !defined(__INTEL_COMPILER) && defined(__x86_64__) && defined(__linux__))
+#   undef DISPATCH
+#endif
+
+#ifdef DISPATCH
+#   define HOT_KERNEL __attribute__((flatten, target_clones ("popcnt", "default")))
+#else
+#   define HOT_KERNEL
+#endif
+
 // ---
 
 #undef ASSERT
@@ -3,7 +3,7 @@
 #include <vector>
 #include <iomanip>
 
-//#include "Position.h"
+#include "Position.h"
 #include "Zobrist.h"
 #include "MoveGenerator.h"
 #include "Notation.h"
@@ -220,7 +220,7 @@ uint64_t PolyglotBook::find_index (const Key key)
 }
 uint64_t PolyglotBook::find_index (const Position &pos)
 {
-    return find_index (ZobPG.compute_posi_key (pos));
+    return find_index (pos.posi_key ());
 }
 
 #ifndef NDEBUG
@@ -241,7 +241,7 @@ Move PolyglotBook::probe_move (const Position &pos, bool pick_best)
         if (!open (_fn_book, ios_base::in)) return MOVE_NONE;
     }
 
-    Key key = ZobPG.compute_posi_key (pos);
+    Key key = pos.posi_key ();
 
     uint64_t index = find_index (key);
     if (ERROR_INDEX == index) return MOVE_NONE;
@@ -374,7 +374,7 @@ string PolyglotBook::read_entries (const Position &pos)
 {
     if (!fstream::is_open () || !(_mode & ios_base::in)) return "";
 
-    Key key = ZobPG.compute_posi_key (pos);
+    Key key = pos.posi_key ();
 
     uint64_t index = find_index (key);
     if (ERROR_INDEX == index)
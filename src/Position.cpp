@@ -55,9 +55,25 @@ namespace {
     // calculate the quad words (64bits) needed to be copied.
     const uint32_t SIZE_COPY_STATE = offsetof (StateInfo, posi_key);
 
+    static_assert (sizeof (StateInfo) <= 64, "StateInfo must fit in a cache line");
+
     CACHE_ALIGN(32)
         Score psq[CLR_NO][NONE][SQ_NO];
 
+    // Cuckoo tables of the reversible moves, the non-pawn moves between two
+    // squares, stored by the key difference they make to the position key.
+    // A move and its reverse have the same key, so only one is stored.
+    const uint16_t CUCKOO_SIZE = 0x2000;
+
+    Key  CuckooKey [CUCKOO_SIZE];
+    Move CuckooMove[CUCKOO_SIZE];
+
+    // FenPiece[char] is the piece of a FEN letter, EMPTY for any other char
+    Piece FenPiece[0x100];
+
+    inline uint16_t cuckoo_h1 (Key key) { return uint16_t (key >>  0) & (CUCKOO_SIZE - 1); }
+    inline uint16_t cuckoo_h2 (Key key) { return uint16_t (key >> 16) & (CUCKOO_SIZE - 1); }
+
 #define S(mg, eg) mk_score (mg, eg)
 
     // PSQT[PieceType][Square] contains Piece-Square scores. For each piece type on
@@ -188,6 +204,40 @@ void Position::initialize ()
             psq[BLACK][pt][~s] = -psq_score;
         }
     }
+
+    fill (FenPiece, FenPiece + 0x100, EMPTY);
+    for (uint8_t i = 0; i < CharPiece.length (); ++i)
+    {
+        if (' ' != CharPiece[i]) FenPiece[uint8_t (CharPiece[i])] = Piece (i);
+    }
+
+    std::memset (CuckooKey , 0, sizeof (CuckooKey));
+    std::memset (CuckooMove, 0, sizeof (CuckooMove));
+    for (Color c = WHITE; c <= BLACK; ++c)
+    {
+        for (PieceT pt = NIHT; pt <= KING; ++pt)
+        {
+            for (Square s1 = SQ_A1; s1 <= SQ_H8; ++s1)
+            {
+                for (Square s2 = s1 + 1; s2 <= SQ_H8; ++s2)
+                {
+                    if (!(_attacks_type_bb[pt][s1] & s2)) continue;
+
+                    Move m  = mk_move<NORMAL> (s1, s2);
+                    Key key = ZobPG._.psq_k[c][pt][s1] ^ ZobPG._.psq_k[c][pt][s2] ^ ZobPG._.mover_side;
+                    // Cuckoo insertion, displacing the resident to its other slot
+                    uint16_t i = cuckoo_h1 (key);
+                    while (true)
+                    {
+                        swap (CuckooKey [i], key);
+                        swap (CuckooMove[i], m);
+                        if (MOVE_NONE == m) break;
+                        i = (i == cuckoo_h1 (key)) ? cuckoo_h2 (key) : cuckoo_h1 (key);
+                    }
+                }
+            }
+        }
+    }
 }
 
 // operator= (pos), copy the 'pos'.
@@ -225,18 +275,31 @@ bool Position::draw () const
     }
 
     // Draw by Threefold Repetition?
-    const StateInfo *sip = _si;
     int32_t ply = min (_si->null_ply, _si->clock50);
-    while (ply >= 2)
+    if (_thread)
     {
-        if (sip->p_si && sip->p_si->p_si)
+        // Same side to move at least 4 plies back, from the thread's key history
+        const Key *keys = _thread->key_history;
+        for (int32_t i = 4; i <= ply; i += 2)
         {
-            sip = sip->p_si->p_si;
-            if (sip->posi_key == _si->posi_key)
+            if (keys[(_game_ply - i) & (MAX_KEY_HISTORY - 1)] == _si->posi_key)
                 return true; // Draw at first repetition
-            ply -= 2;
         }
-        else break;
+    }
+    else
+    {
+        const StateInfo *sip = _si;
+        while (ply >= 2)
+        {
+            if (sip->p_si && sip->p_si->p_si)
+            {
+                sip = sip->p_si->p_si;
+                if (sip->posi_key == _si->posi_key)
+                    return true; // Draw at first repetition
+                ply -= 2;
+            }
+            else break;
+        }
     }
 
     //// Draw by Stalemate?
@@ -247,6 +310,82 @@ bool Position::draw () const
 
     return false;
 }
+
+// upcoming_repetition() tests if the side to move has a move which draws by
+// repetition, or if a position within the search path has already repeated.
+// A single reversible move from the current position to the one 'i' plies
+// back changes the key by exactly that move's key, which is looked up in
+// the cuckoo tables, then the move must be unobstructed.
+// 'ply' is the distance from the search root. Needs the thread key history.
+bool Position::upcoming_repetition (int32_t ply) const
+{
+    int32_t end = min (_si->null_ply, _si->clock50);
+    if (end < 3) return false;
+
+    const Key *keys = _thread->key_history;
+    Key posi_key = _si->posi_key;
+    Bitboard occ = pieces ();
+
+    for (int32_t i = 3; i <= end; i += 2)
+    {
+        Key key = keys[(_game_ply - i) & (MAX_KEY_HISTORY - 1)];
+        Key move_key = posi_key ^ key;
+
+        uint16_t j = cuckoo_h1 (move_key);
+        if (CuckooKey[j] != move_key)
+        {
+            j = cuckoo_h2 (move_key);
+            if (CuckooKey[j] != move_key) continue;
+        }
+
+        Move m = CuckooMove[j];
+        Square s1 = org_sq (m);
+        Square s2 = dst_sq (m);
+        if (betwen_sq_bb (s1, s2) & occ) continue;
+
+        // Within the search tree a single repetition is a draw
+        if (ply > i) return true;
+
+        // Before or at the root the move must be one of the side to move,
+        // and the position reached must have already occurred once before
+        if (_color (_piece_arr[EMPTY == _piece_arr[s1] ? s2 : s1]) != _active) continue;
+
+        for (int32_t k = i + 2; k <= end; k += 2)
+        {
+            if (keys[(_game_ply - k) & (MAX_KEY_HISTORY - 1)] == key) return true;
+        }
+    }
+
+    return false;
+}
+
+// sync_key_history() writes the keys of the positions draw() can look back to
+// into the thread's key history. Needed when the position is set up or copied
+// to a thread, after that do_move() keeps it.
+// When copied from a position of another thread, as at split points, the keys
+// are taken from that thread's key history, which holds them contiguously,
+// otherwise from the StateInfo list, one cache line per ply.
+void Position::sync_key_history (const Thread *src) const
+{
+    Key *keys = _thread->key_history;
+    int32_t ply = min<int32_t> (min (_si->null_ply, _si->clock50), MAX_KEY_HISTORY - 1);
+
+    if (src && src != _thread)
+    {
+        for (int32_t i = ply; i >= 0; --i)
+        {
+            uint16_t k = (_game_ply - i) & (MAX_KEY_HISTORY - 1);
+            keys[k] = src->key_history[k];
+        }
+        return;
+    }
+
+    const StateInfo *sip = _si;
+    for (int32_t i = 0; sip && i <= ply; ++i, sip = sip->p_si)
+    {
+        keys[(_game_ply - i) & (MAX_KEY_HISTORY - 1)] = sip->posi_key;
+    }
+}
 // Position consistency test, for debugging
 bool Position::ok (int8_t *failed_step) const
 {
@@ -468,18 +607,18 @@ bool Position::ok (int8_t *failed_step) const
     // step 13
     if (++(*step), debug_matl_key)
     {
-        if (ZobGlob.compute_matl_key (*this) != _si->matl_key) return false;
+        if (ZobPG.compute_matl_key (*this) != _si->matl_key) return false;
     }
     // step 14
     if (++(*step), debug_pawn_key)
     {
-        if (ZobGlob.compute_pawn_key (*this) != _si->pawn_key) return false;
+        if (ZobPG.compute_pawn_key (*this) != _si->pawn_key) return false;
     }
 
     // step 15
     if (++(*step), debug_posi_key)
     {
-        if (ZobGlob.compute_posi_key (*this) != _si->posi_key) return false;
+        if (ZobPG.compute_posi_key (*this) != _si->posi_key) return false;
     }
 
     // step 16
@@ -512,10 +651,7 @@ int32_t Position::see      (Move m) const
     // side to move
     Color stm = _color (piece_on (org));
 
-    // Gain list
-    int32_t swap_list[32];
-    int8_t depth = 1;
-    swap_list[0] = PieceValue[MG][_ptype (piece_on (dst))];
+    int32_t captured = PieceValue[MG][_ptype (piece_on (dst))];
 
     Bitboard occupied = pieces () - org;
 
@@ -531,13 +667,25 @@ int32_t Position::see      (Move m) const
     else if (ENPASSANT == mt)
     {
         occupied -= (dst - pawn_push (stm)); // Remove the captured pawn
-        swap_list[0] = PieceValue[MG][PAWN];
+        captured = PieceValue[MG][PAWN];
     }
 
     // Find all attackers to the destination square, with the moving piece
     // removed, but possibly an X-ray attacker added behind it.
     Bitboard attackers = attackers_to (dst, occupied) & occupied;
 
+    return see_swap (dst, stm, captured, _ptype (piece_on (org)), occupied, attackers);
+}
+
+// see_swap() is the exchange part of see(), starting after the first capture
+// made by the 'stm' side with a 'ct' piece, which won 'captured'.
+int32_t Position::see_swap (Square dst, Color stm, int32_t captured, PieceT ct, Bitboard occupied, Bitboard attackers) const
+{
+    // Gain list
+    int32_t swap_list[32];
+    int8_t depth = 1;
+    swap_list[0] = captured;
+
     // If the opponent has no attackers we are finished
     stm = ~stm;
     Bitboard stm_attackers = attackers & pieces (stm);
@@ -549,8 +697,6 @@ int32_t Position::see      (Move m) const
     // destination square, where the sides alternately capture, and always
     // capture with the least valuable piece. After each capture, we look for
     // new X-ray attacks from behind the capturing piece.
-    PieceT ct = _ptype (piece_on (org));
-
     do
     {
         ASSERT (depth < 32);
@@ -602,6 +748,90 @@ int32_t Position::see_sign (Move m) const
     return see (m);
 }
 
+// see_ge() tests if the SEE value of the move is at least the threshold.
+// It keeps only the running balance of the exchange and stops as soon as
+// the side to move can no longer change the outcome, without a swap list.
+bool Position::see_ge   (Move m, int32_t threshold) const
+{
+    Square org = org_sq (m);
+    Square dst = dst_sq (m);
+
+    MoveT mt = mtype (m);
+    // Castle moves are king capturing the rook, see() values them 0
+    if (CASTLE == mt) return 0 >= threshold;
+
+    Color stm = _color (piece_on (org));
+    Bitboard occupied = pieces () - org;
+
+    int32_t balance = PieceValue[MG][_ptype (piece_on (dst))];
+    if (ENPASSANT == mt)
+    {
+        occupied -= (dst - pawn_push (stm)); // Remove the captured pawn
+        balance = PieceValue[MG][PAWN];
+    }
+
+    // Even if the capture is not recaptured it does not reach the threshold
+    if (balance < threshold) return false;
+
+    // Even if the capturing piece is lost it reaches the threshold
+    balance -= PieceValue[MG][_ptype (piece_on (org))];
+    if (balance >= threshold) return true;
+
+    Bitboard attackers = attackers_to (dst, occupied) & occupied;
+
+    // 'relative' is true when the opponent of the moving side is to capture,
+    // the balance is from the point of view of the moving side.
+    bool relative = true;
+    while (true)
+    {
+        stm = ~stm;
+        Bitboard stm_attackers = attackers & pieces (stm);
+        if (!stm_attackers) return relative;
+
+        PieceT ct = min_attacker<PAWN> (_types_bb, dst, stm_attackers, occupied, attackers);
+
+        // The king can capture only if the square is no more defended
+        if (KING == ct) return relative == bool (attackers & pieces (~stm));
+
+        balance += relative ? PieceValue[MG][ct] : -PieceValue[MG][ct];
+        relative = !relative;
+
+        if (relative == (balance >= threshold)) return relative;
+    }
+}
+
+// see_batch() computes in one pass the SEE value of all the normal and
+// promotion moves in [beg, end) going to the square 'dst', storing it as
+// their value. The attackers to 'dst' are found once, and per move only the
+// X-ray attackers behind the moving piece are added.
+void Position::see_batch (Square dst, ValMove *beg, ValMove *end) const
+{
+    Bitboard occ = pieces ();
+    Bitboard all_attackers = attackers_to (dst, occ);
+    int32_t captured = PieceValue[MG][_ptype (piece_on (dst))];
+
+    for (ValMove *itr = beg; itr != end; ++itr)
+    {
+        Move m = itr->move;
+        if (dst_sq (m) != dst || ENPASSANT == mtype (m) || CASTLE == mtype (m)) continue;
+
+        Square org = org_sq (m);
+        Bitboard occupied  = occ - org;
+        Bitboard attackers = all_attackers;
+        if (attacks_bb<BSHP> (dst) & org)
+        {
+            attackers |= attacks_bb<BSHP> (dst, occupied) & pieces (BSHP, QUEN);
+        }
+        else if (attacks_bb<ROOK> (dst) & org)
+        {
+            attackers |= attacks_bb<ROOK> (dst, occupied) & pieces (ROOK, QUEN);
+        }
+        attackers &= occupied;
+
+        itr->value = Value (see_swap (dst, _color (piece_on (org)), captured, _ptype (piece_on (org)), occupied, attackers));
+    }
+}
+
 Bitboard Position::check_blockers (Color c, Color king_c) const
 {
     Square ksq = king_sq (king_c);
@@ -626,6 +856,34 @@ Bitboard Position::check_blockers (Color c, Color king_c) const
 }
 
 
+template<bool CHESS960>
+// castle_unattacked() tests whether the squares the king crosses when castling
+// with the given rook, the destination included, are all safe. In Chess960 the
+// king can move either way, and moving the rook away can uncover an attack on
+// the king destination, which is not possible in standard chess.
+bool Position::castle_unattacked (Square org_king, Square org_rook) const
+{
+    bool king_side  = (org_rook > org_king);
+    Square dst_king = rel_sq (_active, king_side ? SQ_WK_K : SQ_WK_Q);
+    Bitboard enemies = pieces (~_active);
+
+    Delta step = CHESS960 ?
+        dst_king < org_king ? DEL_W : DEL_E :
+        king_side           ? DEL_E : DEL_W;
+
+    for (Square s = org_king + step; s != dst_king + step; s += step)
+    {
+        if (attackers_to (s) & enemies) return false;
+    }
+
+    if (CHESS960)
+    {
+        if (attackers_to (dst_king, pieces () - org_rook) & pieces (ROOK, QUEN) & enemies) return false;
+    }
+
+    return true;
+}
+
 // pseudo_legal(m) tests whether a random move is pseudo-legal.
 // It is used to validate moves from TT that can be corrupted
 // due to SMP concurrent access or hash position key aliasing.
@@ -671,31 +929,18 @@ bool Position::pseudo_legal (Move m) const
         if (R_1 != r_org || R_1 != r_dst) return false;
 
         //if (castle_impeded (active)) return false;
-        if (!can_castle (active)) return false;
         if (checkers ()) return false;
 
-        bool king_side  = (dst > org);
-        if (castle_impeded (active, king_side ? CS_K : CS_Q)) return false;
+        CSide cs = (dst > org) ? CS_K : CS_Q;
+        if (!can_castle (active, cs) || castle_impeded (active, cs)) return false;
 
         Square org_rook = dst; // castle is always encoded as "king captures friendly rook"
-        ASSERT (org_rook == castle_rook (active, king_side ? CS_K : CS_Q));
-
-        dst             = rel_sq (active, king_side ? SQ_WK_K : SQ_WK_Q);
-        //Square dst_rook = rel_sq (active, king_side ? SQ_WR_K : SQ_WR_Q);
-        Delta step      = king_side ? DEL_E : DEL_W;
-        Bitboard enemies = pieces (pasive);
-        Square s  = org + step;
-        while (s != dst + step)
-        {
-            if (attackers_to (s) & enemies)
-            {
-                return false;
-            }
-            s += step;
-        }
+        if (org_rook != castle_rook (active, cs)) return false;
 
         //ct = NONE;
-        return true;
+        return _chess960 ?
+            castle_unattacked<true > (org, org_rook) :
+            castle_unattacked<false> (org, org_rook);
 
     }
     else if (PROMOTE == mt)
@@ -1066,18 +1311,13 @@ bool Position::can_en_passant (Square ep_sq) const
     ASSERT (pop_count<FULL> (pawns_ep) <= 2);
     if (!pawns_ep) return false;
 
-    vector<Move> mov_ep;
-    while (pawns_ep) mov_ep.push_back (mk_move<ENPASSANT> (pop_lsq (pawns_ep), ep_sq));
-
     // Check en-passant is legal for the position
     Square fk_sq = king_sq (active);
     Bitboard occ = pieces ();
-    for (vector<Move>::const_iterator itr = mov_ep.begin (); itr != mov_ep.end (); ++itr)
+    while (pawns_ep)
     {
-        Move m = *itr;
-        Square org = org_sq (m);
-        Square dst = dst_sq (m);
-        Bitboard mocc = occ - org - cap + dst;
+        Square org = pop_lsq (pawns_ep);
+        Bitboard mocc = occ - org - cap + ep_sq;
         if (!(
             (attacks_bb<ROOK> (fk_sq, mocc) & pieces (pasive, QUEN, ROOK)) |
             (attacks_bb<BSHP> (fk_sq, mocc) & pieces (pasive, QUEN, BSHP))))
@@ -1217,21 +1457,21 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
         // If the captured piece is a pawn
         if (PAWN == ct) // Update pawn hash key
         {
-            _si->pawn_key ^= ZobGlob._.psq_k[pasive][PAWN][cap];
+            _si->pawn_key ^= ZobPG._.psq_k[pasive][PAWN][cap];
         }
         else            // Update non-pawn material
         {
             _si->non_pawn_matl[pasive] -= PieceValue[MG][ct];
         }
         // Update Hash key of material situation and prefetch access to material_table
-        _si->matl_key ^= ZobGlob._.psq_k[pasive][ct][count (pasive, ct)];
+        _si->matl_key ^= ZobPG._.psq_k[pasive][ct][count (pasive, ct)];
 
 #ifndef NDEBUG
         if (_thread)
 #endif
             prefetch ((char*) _thread->material_table[_si->matl_key]);
         // Update Hash key of position
-        posi_k ^= ZobGlob._.psq_k[pasive][ct][cap];
+        posi_k ^= ZobPG._.psq_k[pasive][ct][cap];
         // Update incremental scores
         _si->psq_score -= psq[pasive][ct][cap];
         // Reset Rule-50 draw counter
@@ -1252,7 +1492,7 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
     // Reset old en-passant square
     if (SQ_NO != _si->en_passant)
     {
-        posi_k ^= ZobGlob._.en_passant[_file (_si->en_passant)];
+        posi_k ^= ZobPG._.en_passant[_file (_si->en_passant)];
         _si->en_passant = SQ_NO;
     }
 
@@ -1266,15 +1506,15 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
         if (PAWN == pt)
         {
             _si->pawn_key ^=
-                ZobGlob._.psq_k[active][PAWN][org] ^
-                ZobGlob._.psq_k[active][PAWN][dst];
+                ZobPG._.psq_k[active][PAWN][org] ^
+                ZobPG._.psq_k[active][PAWN][dst];
         }
-        posi_k ^= ZobGlob._.psq_k[active][pt][org] ^ ZobGlob._.psq_k[active][pt][dst];
+        posi_k ^= ZobPG._.psq_k[active][pt][org] ^ ZobPG._.psq_k[active][pt][dst];
         _si->psq_score += psq[active][pt][dst] - psq[active][pt][org];
     }
     else if (CASTLE == mt)
     {
-        // Move the piece. The tricky Chess960 castle is handled earlier
+        // Move the king and the rook, specialized for standard chess
         bool king_side  = (dst > org);
         Square org_rook = dst; // castle is always encoded as "king captures friendly rook"
         dst             = rel_sq (active, king_side ? SQ_WK_K : SQ_WK_Q);
@@ -1283,10 +1523,12 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
         ASSERT (org_rook == castle_rook (active, king_side ? CS_K : CS_Q));
         ASSERT (empty (dst_rook));
 
-        castle_king_rook (org, dst, org_rook, dst_rook);
+        _chess960 ?
+            castle_king_rook<true > (org, dst, org_rook, dst_rook) :
+            castle_king_rook<false> (org, dst, org_rook, dst_rook);
 
-        posi_k ^= ZobGlob._.psq_k[_active][KING][org     ] ^ ZobGlob._.psq_k[_active][KING][dst     ];
-        posi_k ^= ZobGlob._.psq_k[_active][ROOK][org_rook] ^ ZobGlob._.psq_k[_active][ROOK][dst_rook];
+        posi_k ^= ZobPG._.psq_k[_active][KING][org     ] ^ ZobPG._.psq_k[_active][KING][dst     ];
+        posi_k ^= ZobPG._.psq_k[_active][ROOK][org_rook] ^ ZobPG._.psq_k[_active][ROOK][dst_rook];
 
         _si->psq_score += psq[active][KING][dst     ] - psq[active][KING][org     ];
         _si->psq_score += psq[active][ROOK][dst_rook] - psq[active][ROOK][org_rook];
@@ -1299,12 +1541,12 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
         place_piece (dst, active, ppt);
 
         _si->matl_key ^=
-            ZobGlob._.psq_k[active][PAWN][count (active, PAWN)] ^
-            ZobGlob._.psq_k[active][ppt][count (active, ppt) - 1];
+            ZobPG._.psq_k[active][PAWN][count (active, PAWN)] ^
+            ZobPG._.psq_k[active][ppt][count (active, ppt) - 1];
 
-        _si->pawn_key ^= ZobGlob._.psq_k[active][PAWN][org];
+        _si->pawn_key ^= ZobPG._.psq_k[active][PAWN][org];
 
-        posi_k ^= ZobGlob._.psq_k[active][PAWN][org] ^ ZobGlob._.psq_k[active][ppt][dst];
+        posi_k ^= ZobPG._.psq_k[active][PAWN][org] ^ ZobPG._.psq_k[active][ppt][dst];
 
         // Update incremental score
         _si->psq_score += psq[active][ppt][dst] - psq[active][PAWN][org];
@@ -1320,7 +1562,7 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
         _si->castle_rights &= ~cr;
         while (b)
         {
-            posi_k ^= ZobGlob._.castle_right[0][pop_lsq (b)];
+            posi_k ^= ZobPG._.castle_right[0][pop_lsq (b)];
         }
     }
 
@@ -1361,7 +1603,7 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
 
     // Switch side to move
     _active = pasive;
-    posi_k ^= ZobGlob._.mover_side;
+    posi_k ^= ZobPG._.mover_side;
 
     // Handle pawn en-passant square setting
     if (PAWN == pt)
@@ -1374,7 +1616,7 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
             if (can_en_passant (ep_sq))
             {
                 _si->en_passant = ep_sq;
-                posi_k ^= ZobGlob._.en_passant[_file (ep_sq)];
+                posi_k ^= ZobPG._.en_passant[_file (ep_sq)];
             }
         }
 
@@ -1392,6 +1634,9 @@ void Position::do_move (Move m, StateInfo &si_n, const CheckInfo *ci)
     ++_game_ply;
     ++_game_nodes;
 
+    if (_thread)
+        _thread->key_history[_game_ply & (MAX_KEY_HISTORY - 1)] = posi_k;
+
     ASSERT (ok ());
 }
 void Position::do_move (Move m, StateInfo &si_n)
@@ -1443,7 +1688,9 @@ void Position::undo_move ()
 
         pt  = KING;
         ct  = NONE;
-        castle_king_rook (dst, org, dst_rook, org_rook);
+        _chess960 ?
+            castle_king_rook<true > (dst, org, dst_rook, org_rook) :
+            castle_king_rook<false> (dst, org, dst_rook, org_rook);
     }
     else if (PROMOTE == mt)
     {
@@ -1497,18 +1744,23 @@ void Position::do_null_move (StateInfo &si_n)
 
     if (SQ_NO != _si->en_passant)
     {
-        _si->posi_key ^= ZobGlob._.en_passant[_file (_si->en_passant)];
+        _si->posi_key ^= ZobPG._.en_passant[_file (_si->en_passant)];
         _si->en_passant = SQ_NO;
     }
 
     _active = ~_active;
-    _si->posi_key ^= ZobGlob._.mover_side;
+    _si->posi_key ^= ZobPG._.mover_side;
 
     prefetch ((char *) TT.get_cluster (_si->posi_key));
 
     _si->clock50++;
     _si->null_ply = 0;
 
+    // The null move keeps the game ply, so its key takes the slot of the
+    // position before it until undo_null_move()
+    if (_thread)
+        _thread->key_history[_game_ply & (MAX_KEY_HISTORY - 1)] = _si->posi_key;
+
     ASSERT (ok ());
 }
 // undo_null_move() undo the null-move
@@ -1520,6 +1772,9 @@ void Position::undo_null_move ()
     _active = ~_active;
     _si     = _si->p_si;
 
+    if (_thread)
+        _thread->key_history[_game_ply & (MAX_KEY_HISTORY - 1)] = _si->posi_key;
+
     ASSERT (ok ());
 }
 
@@ -1569,9 +1824,9 @@ void Position::flip ()
     //_si->last_move  = MOVE_NONE;
     //_si->checkers   = flip_verti (pos._si->checkers);
     //_active         = ~pos._active;
-    //_si->matl_key   = ZobGlob.compute_matl_key (*this);
-    //_si->pawn_key   = ZobGlob.compute_pawn_key (*this);
-    //_si->posi_key   = ZobGlob.compute_posi_key (*this);
+    //_si->matl_key   = ZobPG.compute_matl_key (*this);
+    //_si->pawn_key   = ZobPG.compute_pawn_key (*this);
+    //_si->posi_key   = ZobPG.compute_posi_key (*this);
     //_si->psq_score  = compute_psq_score ();
     //_si->non_pawn_matl[WHITE] = compute_non_pawn_material (WHITE);
     //_si->non_pawn_matl[BLACK] = compute_non_pawn_material (BLACK);
@@ -2088,9 +2343,9 @@ bool Position::parse (Position &pos, const   char *fen, Thread *thread, bool c96
     pos._si->clock50 = (SQ_NO != pos._si->en_passant) ? 0 : clk50;
     pos._game_ply = max<int16_t> (2 * (g_move - 1), 0) + (BLACK == pos._active);
 
-    pos._si->matl_key = ZobGlob.compute_matl_key (pos);
-    pos._si->pawn_key = ZobGlob.compute_pawn_key (pos);
-    pos._si->posi_key = ZobGlob.compute_posi_key (pos);
+    pos._si->matl_key = ZobPG.compute_matl_key (pos);
+    pos._si->pawn_key = ZobPG.compute_pawn_key (pos);
+    pos._si->posi_key = ZobPG.compute_posi_key (pos);
     pos._si->psq_score = pos.compute_psq_score ();
     pos._si->non_pawn_matl[WHITE] = pos.compute_non_pawn_material (WHITE);
     pos._si->non_pawn_matl[BLACK] = pos.compute_non_pawn_material (BLACK);
@@ -2098,6 +2353,7 @@ bool Position::parse (Position &pos, const   char *fen, Thread *thread, bool c96
     pos._chess960     = c960;
     pos._game_nodes   = 0;
     pos._thread       = thread;
+    if (thread) pos.sync_key_history ();
 
     return true;
 }
@@ -2161,6 +2417,19 @@ bool Position::parse (Position &pos, const string &fen, Thread *thread, bool c96
                 //if (ROOK != _ptype (pos[rook])) return false;
                 pos.set_castle (c, rook);
             }
+            // X-FEN KQkq, the outermost rook on that side of the king
+            else if ('k' == sym)
+            {
+                rook = rel_sq (c, SQ_H1);
+                while ((pos.king_sq (c) < rook) && ((c | ROOK) != pos[rook])) --rook;
+                if ((c | ROOK) == pos[rook]) pos.set_castle (c, rook);
+            }
+            else if ('q' == sym)
+            {
+                rook = rel_sq (c, SQ_A1);
+                while ((pos.king_sq (c) > rook) && ((c | ROOK) != pos[rook])) ++rook;
+                if ((c | ROOK) == pos[rook]) pos.set_castle (c, rook);
+            }
             else
             {
                 continue;
@@ -2219,9 +2488,9 @@ bool Position::parse (Position &pos, const string &fen, Thread *thread, bool c96
     pos._si->clock50 = (SQ_NO != pos._si->en_passant) ? 0 : clk50;
     pos._game_ply = max (2 * (g_move - 1), 0) + (BLACK == pos._active);
 
-    pos._si->matl_key = ZobGlob.compute_matl_key (pos);
-    pos._si->pawn_key = ZobGlob.compute_pawn_key (pos);
-    pos._si->posi_key = ZobGlob.compute_posi_key (pos);
+    pos._si->matl_key = ZobPG.compute_matl_key (pos);
+    pos._si->pawn_key = ZobPG.compute_pawn_key (pos);
+    pos._si->posi_key = ZobPG.compute_posi_key (pos);
     pos._si->psq_score = pos.compute_psq_score ();
     pos._si->non_pawn_matl[WHITE] = pos.compute_non_pawn_material (WHITE);
     pos._si->non_pawn_matl[BLACK] = pos.compute_non_pawn_material (BLACK);
@@ -2229,6 +2498,168 @@ bool Position::parse (Position &pos, const string &fen, Thread *thread, bool c96
     pos._chess960     = c960;
     pos._game_nodes   = 0;
     pos._thread       = thread;
+    if (thread) pos.sync_key_history ();
 
     return true;
 }
+
+// load() sets up the position from the FEN or EPD record at 'fen' for the bulk
+// imports, in one pass and without allocations: the record is validated while
+// it is read, and the keys, the psq score and the material are accumulated in
+// the placement loop instead of recomputed from scratch afterwards.
+// The clocks are optional, as in EPD. Returns the end of the fields read (the
+// EPD operations if any) or NULL if the record is not a valid position.
+const char* Position::load (Position &pos, const char *fen, Thread *thread, bool c960)
+{
+    if (!fen) return NULL;
+
+    pos.clear ();
+
+    Key matl_key = U64 (0);
+    Key pawn_key = U64 (0);
+    Key posi_key = U64 (0);
+    Score psq_score = SCORE_ZERO;
+    Value npm[CLR_NO] = { VALUE_ZERO, VALUE_ZERO };
+
+    // 1. Piece placement on Board
+    for (Rank r = R_8; r >= R_1; --r)
+    {
+        File f = F_A;
+        while (f <= F_H)
+        {
+            uint8_t ch = *fen++;
+            if ('1' <= ch && ch <= '8')
+            {
+                f += (ch - '0');
+                if (f > F_NO) return NULL;
+                continue;
+            }
+
+            Piece p = FenPiece[ch];
+            if (EMPTY == p) return NULL;
+
+            Color  c  = _color (p);
+            PieceT pt = _ptype (p);
+            Square s  = (f | r);
+            if (PAWN == pt && (R_1 == r || R_8 == r)) return NULL;
+            if (pos._piece_count[c][NONE] >= 16 || pos._piece_count[c][pt] >= (PAWN == pt ? 8 : KING == pt ? 1 : 10)) return NULL;
+
+            if (KING != pt) matl_key ^= ZobPG._.psq_k[c][pt][pos._piece_count[c][pt]];
+            if (PAWN == pt) pawn_key ^= ZobPG._.psq_k[c][pt][s];
+            else if (KING != pt) npm[c] += PieceValue[MG][pt];
+            posi_key  ^= ZobPG._.psq_k[c][pt][s];
+            psq_score += psq[c][pt][s];
+
+            pos.place_piece (s, c, pt);
+            ++f;
+        }
+        if (R_1 < r && '/' != *fen++) return NULL;
+    }
+    if (1 != pos._piece_count[WHITE][KING] || 1 != pos._piece_count[BLACK][KING]) return NULL;
+
+    // 2. Active color
+    if (' ' != *fen++) return NULL;
+    switch (*fen++)
+    {
+    case 'w': pos._active = WHITE; break;
+    case 'b': pos._active = BLACK; break;
+    default: return NULL;
+    }
+    // The side not to move cannot be in check
+    if (pos.checkers (~pos._active)) return NULL;
+
+    // 3. Castling rights availability (KQkq, Shredder-FEN or X-FEN)
+    if (' ' != *fen++) return NULL;
+    if ('-' == *fen)
+    {
+        ++fen;
+    }
+    else
+    {
+        while (*fen && ' ' != *fen)
+        {
+            uint8_t ch = *fen++;
+            Color c = isupper (ch) ? WHITE : BLACK;
+            if (R_1 != rel_rank (c, pos.king_sq (c))) return NULL;
+
+            Square rook;
+            char sym = tolower (ch);
+            // KQkq is the outermost own rook on that side of the king (also X-FEN)
+            if      ('k' == sym)
+            {
+                rook = rel_sq (c, SQ_H1);
+                while ((pos.king_sq (c) < rook) && ((c | ROOK) != pos[rook])) --rook;
+            }
+            else if ('q' == sym)
+            {
+                rook = rel_sq (c, SQ_A1);
+                while ((pos.king_sq (c) > rook) && ((c | ROOK) != pos[rook])) ++rook;
+            }
+            else if ('a' <= sym && sym <= 'h')
+            {
+                rook = (to_file (sym) | rel_rank (c, R_1));
+            }
+            else
+            {
+                return NULL;
+            }
+            if ((c | ROOK) != pos[rook]) return NULL;
+            pos.set_castle (c, rook);
+        }
+    }
+    Bitboard b = pos._si->castle_rights;
+    while (b) posi_key ^= ZobPG._.castle_right[0][pop_lsq (b)];
+
+    // 4. En-passant square, ignored if no pawn capture is possible
+    if (' ' != *fen++) return NULL;
+    if ('-' == *fen)
+    {
+        ++fen;
+    }
+    else
+    {
+        uint8_t ep_f = *fen++;
+        uint8_t ep_r = *fen++;
+        if ('a' > ep_f || ep_f > 'h') return NULL;
+        if ((WHITE == pos._active ? '6' : '3') != ep_r) return NULL;
+
+        Square ep_sq = to_square (ep_f, ep_r);
+        if (pos.can_en_passant (ep_sq))
+        {
+            pos._si->en_passant = ep_sq;
+            posi_key ^= ZobPG._.en_passant[_file (ep_sq)];
+        }
+    }
+    if (WHITE == pos._active) posi_key ^= ZobPG._.mover_side;
+
+    // 5-6. 50-move clock and game-move count, optional
+    int32_t clk50 = 0, g_move = 1;
+    if (' ' == fen[0] && isdigit (uint8_t (fen[1])))
+    {
+        for (++fen; isdigit (uint8_t (*fen)); ++fen) clk50 = 10 * clk50 + (*fen - '0');
+        if (100 < clk50) return NULL;
+
+        if (' ' != *fen++ || !isdigit (uint8_t (*fen))) return NULL;
+        g_move = 0;
+        for (; isdigit (uint8_t (*fen)); ++fen) g_move = 10 * g_move + (*fen - '0');
+    }
+
+    // Convert from game_move starting from 1 to game_ply starting from 0,
+    // handle also common incorrect FEN with game_move = 0.
+    pos._si->clock50 = (SQ_NO != pos._si->en_passant) ? 0 : clk50;
+    pos._game_ply = max (2 * (g_move - 1), 0) + (BLACK == pos._active);
+
+    pos._si->matl_key = matl_key;
+    pos._si->pawn_key = pawn_key;
+    pos._si->posi_key = posi_key;
+    pos._si->psq_score = psq_score;
+    pos._si->non_pawn_matl[WHITE] = npm[WHITE];
+    pos._si->non_pawn_matl[BLACK] = npm[BLACK];
+    pos._si->checkers = pos.checkers (pos._active);
+    pos._chess960     = c960;
+    pos._game_nodes   = 0;
+    pos._thread       = thread;
+    if (thread) pos.sync_key_history ();
+
+    return fen;
+}
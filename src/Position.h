@@ -9,6 +9,7 @@
 #include "BitBoard.h"
 #include "BitScan.h"
 #include "Zobrist.h"
+#include "MoveGenerator.h"
 
 class Position;
 struct Thread;
@@ -52,39 +53,46 @@ extern bool _ok (const std::string &fen, bool c960 = false, bool full = true);
 //  - Bitboard of all checking pieces.
 //  - Pointer to previous StateInfo. 
 //  - Hash keys for all previous positions in the game for detecting repetition draws.
+//
+// The fields are narrowed and ordered to keep the padding small, so that the
+// whole state fits in one 64-byte cache line on 64-bit. The ones copied on
+// do_move() come first, the ones always recomputed from 'posi_key' on.
 typedef struct StateInfo
 {
 public:
 
-    Value non_pawn_matl[CLR_NO];
-    Score psq_score;
-
     // Hash key of materials.
     Key matl_key;
     // Hash key of pawns.
     Key pawn_key;
 
-    // Castling-rights information for both side.
-    CRight castle_rights;
+    Value non_pawn_matl[CLR_NO];
+    Score psq_score;
 
-    // "In passing" - Target square in algebraic notation.
-    // If there's no en-passant target square is "-".
-    Square en_passant;
     // Number of halfmoves clock since the last pawn advance or any capture.
     // used to determine if a draw can be claimed under the 50-move rule.
-    uint32_t
+    uint16_t
         clock50,
         null_ply;
 
-    // -------------------------------------
+    // Castling-rights information for both side.
+    CRight castle_rights;
+
+    // "In passing" - Target square in algebraic notation.
+    // If there's no en-passant target square is "-".
+    Square en_passant;
 
-    // Hash key of position.
-    Key posi_key;
     // Move played on the previous position.
+    // Set by do_move(), kept here as it fills the padding before 'posi_key'.
     Move last_move;
     // Piece type captured.
     PieceT cap_type;
 
+    // -------------------------------------
+
+    // Hash key of position.
+    Key posi_key;
+
     Bitboard checkers;
 
     StateInfo *p_si;
@@ -193,7 +201,7 @@ public:
     {
         if (!setup (f, th, c960, full)) clear ();
     }
-    Position (const Position &pos, Thread *th = NULL) { *this = pos; _thread = th; }
+    Position (const Position &pos, Thread *th = NULL) { *this = pos; _thread = th; if (th) sync_key_history (pos._thread); }
     //Position (const Position &pos) { *this = pos; }
 
     explicit Position (int8_t dummy) { ++dummy; }
@@ -296,17 +304,23 @@ public:
     Thread* thread     ()               const;
 
     bool draw ()                        const;
+    bool upcoming_repetition (int32_t ply) const;
+    void sync_key_history (const Thread *src = NULL) const;
     bool ok (int8_t *failed_step = NULL) const;
 
     // Static Exchange Evaluation (SEE)
     int32_t see      (Move m) const;
     int32_t see_sign (Move m) const;
+    bool    see_ge   (Move m, int32_t threshold) const;
+    void    see_batch (Square dst, ValMove *beg, ValMove *end) const;
 
 
 private:
 
     Bitboard check_blockers (Color c, Color king_c) const;
 
+    int32_t see_swap (Square dst, Color stm, int32_t captured, PieceT ct, Bitboard occupied, Bitboard attackers) const;
+
 public:
 
     template<PieceT PT>
@@ -377,8 +391,12 @@ public:
 
 
 private:
+    template<bool CHESS960>
     void castle_king_rook (Square org_king, Square dst_king, Square org_rook, Square dst_rook);
 
+    template<bool CHESS960>
+    bool castle_unattacked (Square org_king, Square org_rook) const;
+
 public:
     // do/undo move
     void do_move (Move m, StateInfo &si_n, const CheckInfo *ci);
@@ -402,6 +420,8 @@ public:
 #endif
     static bool parse (Position &pos, const std::string &fen, Thread *thread = NULL, bool c960 = false, bool full = true);
 
+    static const char* load (Position &pos, const char *fen, Thread *thread = NULL, bool c960 = false);
+
 
     template<class charT, class Traits>
     friend std::basic_ostream<charT, Traits>&
@@ -804,15 +824,25 @@ inline void  Position::  move_piece (Square s1, Square s2)
     _piece_list[c][pt][_piece_index[s2]] = s2;
 }
 
+template<bool CHESS960>
 // castle_king_rook() exchanges the king and rook
 inline void Position::castle_king_rook (Square org_king, Square dst_king, Square org_rook, Square dst_rook)
 {
-    // Remove both pieces first since squares could overlap in chess960
-    remove_piece (org_king);
-    remove_piece (org_rook);
+    if (CHESS960)
+    {
+        // Remove both pieces first since squares could overlap in chess960
+        remove_piece (org_king);
+        remove_piece (org_rook);
 
-    place_piece (dst_king, _active, KING);
-    place_piece (dst_rook, _active, ROOK);
+        place_piece (dst_king, _active, KING);
+        place_piece (dst_rook, _active, ROOK);
+    }
+    else
+    {
+        // In standard chess the four squares are all different
+        move_piece (org_king, dst_king);
+        move_piece (org_rook, dst_rook);
+    }
 }
 
 
@@ -0,0 +1,111 @@
+//#pragma once
+#ifndef SCOREVEC_H_
+#define SCOREVEC_H_
+
+#include "Type.h"
+
+// ScoreVec keeps the middle game and end game values of both colors in four
+// 32-bit lanes { MG(WHITE), EG(WHITE), MG(BLACK), EG(BLACK) }, so that a white
+// and a black term are weighted together with one vector op.
+// The evaluation does not use it: the pack, madd and unpack round trip costs
+// more than the two scalar apply_weight() it replaces (see Tester::test_score()),
+// and most terms are weighted once on the white - black difference anyway.
+// Each lane holds a sign-extended 16-bit value, as in the packed Score.
+// With SSE2 available the lanes live in one XMM register, otherwise falls
+// back to plain scalar arithmetic giving the same results.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define SCOREVEC_SSE2
+#   include <emmintrin.h> // SSE2 intrinsics
+#endif
+
+typedef struct CACHE_ALIGN(16) ScoreVec
+{
+#ifdef SCOREVEC_SSE2
+    __m128i v;
+#else
+    int32_t v[4];
+#endif
+
+} ScoreVec;
+
+#ifdef SCOREVEC_SSE2
+
+INLINE ScoreVec mk_score_vec (Score w, Score b)
+{
+    ScoreVec sv;
+    sv.v = _mm_set_epi32 (eg_value (b), mg_value (b), eg_value (w), mg_value (w));
+    return sv;
+}
+
+INLINE ScoreVec operator+  (ScoreVec sv1, ScoreVec sv2) { ScoreVec sv; sv.v = _mm_add_epi32 (sv1.v, sv2.v); return sv; }
+INLINE ScoreVec operator-  (ScoreVec sv1, ScoreVec sv2) { ScoreVec sv; sv.v = _mm_sub_epi32 (sv1.v, sv2.v); return sv; }
+
+// apply_weight() multiplies each lane by the corresponding (non-negative 16-bit)
+// weight lane and divides by 0x100 rounding toward zero, like the scalar version.
+// _mm_madd_epi16() gives lo16(s) * lo16(w) + hi16(s) * hi16(w) per 32-bit lane,
+// and the weight high halves are zero, so this is an exact signed product.
+INLINE ScoreVec apply_weight (ScoreVec s, ScoreVec w)
+{
+    __m128i prod = _mm_madd_epi16 (s.v, w.v);
+    __m128i bias = _mm_srli_epi32 (_mm_srai_epi32 (prod, 31), 24); // 0xFF if negative
+    ScoreVec sv;
+    sv.v = _mm_srai_epi32 (_mm_add_epi32 (prod, bias), 8);
+    return sv;
+}
+
+// color_score() extracts the Score of the given color
+INLINE Score color_score (ScoreVec sv, Color c)
+{
+    CACHE_ALIGN(16) int32_t lane[4];
+    _mm_store_si128 ((__m128i *) lane, sv.v);
+    return mk_score (lane[2*c + MG], lane[2*c + EG]);
+}
+
+// score_diff() returns the white Score minus the black Score
+INLINE Score score_diff (ScoreVec sv)
+{
+    __m128i diff = _mm_sub_epi32 (sv.v, _mm_unpackhi_epi64 (sv.v, sv.v));
+    return mk_score (_mm_cvtsi128_si32 (diff), _mm_cvtsi128_si32 (_mm_srli_si128 (diff, 4)));
+}
+
+#else
+
+INLINE ScoreVec mk_score_vec (Score w, Score b)
+{
+    ScoreVec sv;
+    sv.v[0] = mg_value (w); sv.v[1] = eg_value (w);
+    sv.v[2] = mg_value (b); sv.v[3] = eg_value (b);
+    return sv;
+}
+
+INLINE ScoreVec operator+  (ScoreVec sv1, ScoreVec sv2)
+{
+    ScoreVec sv;
+    for (int32_t i = 0; i < 4; ++i) sv.v[i] = sv1.v[i] + sv2.v[i];
+    return sv;
+}
+INLINE ScoreVec operator-  (ScoreVec sv1, ScoreVec sv2)
+{
+    ScoreVec sv;
+    for (int32_t i = 0; i < 4; ++i) sv.v[i] = sv1.v[i] - sv2.v[i];
+    return sv;
+}
+
+INLINE ScoreVec apply_weight (ScoreVec s, ScoreVec w)
+{
+    ScoreVec sv;
+    for (int32_t i = 0; i < 4; ++i) sv.v[i] = (s.v[i] * w.v[i]) / 0x100;
+    return sv;
+}
+
+INLINE Score color_score (ScoreVec sv, Color c) { return mk_score (sv.v[2*c + MG], sv.v[2*c + EG]); }
+
+INLINE Score score_diff (ScoreVec sv) { return mk_score (sv.v[0] - sv.v[2], sv.v[1] - sv.v[3]); }
+
+#endif
+
+INLINE ScoreVec& operator+= (ScoreVec &sv1, ScoreVec sv2) { sv1 = sv1 + sv2; return sv1; }
+INLINE ScoreVec& operator-= (ScoreVec &sv1, ScoreVec sv2) { sv1 = sv1 - sv2; return sv1; }
+
+#endif
@@ -59,6 +59,8 @@ namespace {
     point         IterDuration; // Duration of iteration
 
     Value       DrawValue[CLR_NO];
+    // Score at least a draw the nodes with a move repeating a position
+    bool        UpcomingRepetition;
 
     double      BestMoveChanges;
 
@@ -165,11 +167,34 @@ namespace {
     } Skill;
 
 
+    // Perft hash entry: (key ^ data, data) with data = (count << 8) | depth.
+    // Storing the key xor-ed with the data lets the threads share the table
+    // without locking, a torn entry simply fails to verify and is a miss.
+    typedef struct PerftEntry
+    {
+        Key      key;
+        uint64_t data;
+
+    } PerftEntry;
+
+    PerftEntry *PerftTable = NULL;
+    uint64_t    PerftMask  = 0;
+
     // _perft() is our utility to verify move generation. All the leaf nodes
     // up to the given depth are generated and counted and the sum returned.
-    inline uint64_t _perft (Position &pos, const Depth &depth)
+    // The last ply is bulk counted from the size of the legal move list, and
+    // the interior nodes are cached in the perft hash keyed by position and depth.
+    uint64_t _perft (Position &pos, const Depth &depth)
     {
-        const bool leaf = (depth == 2*ONE_MOVE);
+        if (depth <= ONE_MOVE) return MoveList<LEGAL> (pos).size ();
+
+        Key key = pos.posi_key ();
+        PerftEntry *pe = PerftTable + (key & PerftMask);
+        uint64_t data = pe->data;
+        if ((pe->key ^ data) == key && uint8_t (data) == uint8_t (depth / ONE_MOVE))
+        {
+            return (data >> 8);
+        }
 
         uint64_t cnt = 0;
 
@@ -179,13 +204,88 @@ namespace {
         {
             Move m = *itr;
             pos.do_move (m, si, pos.gives_check (m, ci) ? &ci : NULL);
-            cnt += leaf ? MoveList<LEGAL> (pos).size () : _perft (pos, depth - ONE_MOVE);
+            cnt += _perft (pos, depth - ONE_MOVE);
             pos.undo_move ();
-        };
+        }
+
+        data = (cnt << 8) | uint8_t (depth / ONE_MOVE);
+        pe->key  = key ^ data;
+        pe->data = data;
 
         return cnt;
     }
 
+    // PerftSplit is shared by the perft threads, which pick the root moves
+    // one at a time and sum up their counts.
+    typedef struct PerftSplit
+    {
+        const Position *pos;
+        Depth           depth;
+        Move            moves[MAX_MOVES];
+        uint16_t        moves_count;
+
+        Mutex           mutex;
+        uint16_t        next_move;
+        uint64_t        cnt;
+
+    } PerftSplit;
+
+    typedef struct PerftWorker
+    {
+        PerftSplit     *split;
+        Thread         *thread;
+
+    } PerftWorker;
+
+    extern "C" { inline void* perft_routine (void *arg)
+    {
+        PerftWorker *worker = (PerftWorker *) arg;
+        PerftSplit &sp = *worker->split;
+        Position pos (*sp.pos, worker->thread);
+
+        StateInfo si;
+        CheckInfo ci (pos);
+        while (true)
+        {
+            sp.mutex.lock ();
+            uint16_t i = sp.next_move++;
+            sp.mutex.unlock ();
+
+            if (i >= sp.moves_count) break;
+
+            Move m = sp.moves[i];
+            pos.do_move (m, si, pos.gives_check (m, ci) ? &ci : NULL);
+            uint64_t cnt = _perft (pos, sp.depth - ONE_MOVE);
+            pos.undo_move ();
+
+            sp.mutex.lock ();
+            sp.cnt += cnt;
+            sp.mutex.unlock ();
+        }
+        return NULL;
+    } }
+
+    // Move picker counters, collected per thread and node type while profiling
+    enum PickNodeT { PICK_ROOT, PICK_PV, PICK_NONPV, PICK_QS_PV, PICK_QS_NONPV, PICK_NODE_NO };
+
+    typedef struct PickStat
+    {
+        uint64_t nodes;
+        uint64_t generated;
+        uint64_t picked;
+
+    } PickStat;
+
+    PickStat PickStats[MAX_THREADS][PICK_NODE_NO];
+
+    inline void record_picks (const Thread *thread, PickNodeT nt, const MovePicker &mp)
+    {
+        PickStat &stat = PickStats[thread->idx][nt];
+        ++stat.nodes;
+        stat.generated += mp.generated_count ();
+        stat.picked    += mp.picked_count ();
+    }
+
 #pragma region Debug
 
     // Debug functions used mainly to collect run-time statistics
@@ -235,6 +335,8 @@ namespace Searcher {
     // initialize the PRNG only once
     PolyglotBook		Book;
 
+    bool                Profile = false;
+
     // RootMove::extract_pv_from_tt() builds a PV by adding moves from the TT table.
     // We consider also failing high nodes and not only EXACT nodes so to
     // allow to always have a ponder move even when we fail high at root node.
@@ -320,9 +422,115 @@ namespace Searcher {
         }
     }
 
+    // perft() splits the root moves among as many threads as the thread pool
+    // has, each one walking its subtrees with its own copy of the position.
+    // The perft hash takes the memory set by the "Hash" option.
     uint64_t perft (Position &pos, const Depth &depth)
     {
-        return (depth > ONE_MOVE) ? _perft (pos, depth) : MoveList<LEGAL> (pos).size ();
+        if (depth <= ONE_MOVE) return MoveList<LEGAL> (pos).size ();
+
+        uint64_t entries = (uint64_t (int32_t (*(Options["Hash"]))) << 20) / sizeof (PerftEntry);
+        uint64_t size    = 1;
+        while (size * 2 <= entries) size *= 2;
+
+        PerftTable = new PerftEntry[size];
+        PerftMask  = size - 1;
+        std::memset (PerftTable, 0, size * sizeof (PerftEntry));
+
+        PerftSplit sp;
+        sp.pos         = &pos;
+        sp.depth       = depth;
+        sp.moves_count = 0;
+        sp.next_move   = 0;
+        sp.cnt         = 0;
+        for (MoveList<LEGAL> itr (pos); *itr; ++itr)
+        {
+            sp.moves[sp.moves_count++] = *itr;
+        }
+
+        uint8_t num_threads = uint8_t (Threads.size ());
+        NativeHandle handles[MAX_THREADS];
+        PerftWorker  workers[MAX_THREADS];
+        for (uint8_t t = 0; t < num_threads; ++t)
+        {
+            workers[t].split  = &sp;
+            workers[t].thread = Threads[t];
+            thread_create (handles[t], perft_routine, &workers[t]);
+        }
+        for (uint8_t t = 0; t < num_threads; ++t)
+        {
+            thread_join (handles[t]);
+        }
+
+        delete[] PerftTable;
+        PerftTable = NULL;
+
+        return sp.cnt;
+    }
+
+    // reset_profile() clears the move picker and split counters.
+    void reset_profile ()
+    {
+        std::memset (PickStats, 0, sizeof (PickStats));
+        for (uint8_t t = 0; t < Threads.size (); ++t)
+        {
+            Threads[t]->split_count = Threads[t]->split_ticks = 0;
+            Threads[t]->join_count  = Threads[t]->join_ticks  = 0;
+        }
+    }
+
+    // profile() returns, per node type, how many moves the move picker generated
+    // and how many of them were actually handed out to the search, and the
+    // average split and join overhead, summed over all threads since the last
+    // reset_profile().
+    string profile ()
+    {
+        const char *names[PICK_NODE_NO] = { "Root", "PV", "NonPV", "QSearch PV", "QSearch NonPV" };
+
+        PickStat total[PICK_NODE_NO];
+        std::memset (total, 0, sizeof (total));
+        for (int32_t t = 0; t < MAX_THREADS; ++t)
+        {
+            for (int32_t nt = 0; nt < PICK_NODE_NO; ++nt)
+            {
+                total[nt].nodes     += PickStats[t][nt].nodes;
+                total[nt].generated += PickStats[t][nt].generated;
+                total[nt].picked    += PickStats[t][nt].picked;
+            }
+        }
+
+        ostringstream oss;
+        oss << setw (20)
+            << "Node type"      << " |        Nodes |  Generated |   Picked |  Gen/Node | Pick/Node \n"
+            << "---------------------+--------------+------------+----------+-----------+-----------\n";
+
+        oss << fixed << setprecision (2);
+        for (int32_t nt = 0; nt < PICK_NODE_NO; ++nt)
+        {
+            uint64_t nodes = total[nt].nodes;
+            oss << setw (20) << names[nt] << " | "
+                << setw (12) << nodes << " | "
+                << setw (10) << total[nt].generated << " | "
+                << setw (8)  << total[nt].picked << " | "
+                << setw (9)  << (nodes ? double (total[nt].generated) / nodes : 0.0) << " | "
+                << setw (9)  << (nodes ? double (total[nt].picked)    / nodes : 0.0) << "\n";
+        }
+
+        uint64_t split_count = 0, split_ticks = 0, join_count = 0, join_ticks = 0;
+        for (uint8_t t = 0; t < Threads.size (); ++t)
+        {
+            split_count += Threads[t]->split_count;
+            split_ticks += Threads[t]->split_ticks;
+            join_count  += Threads[t]->join_count;
+            join_ticks  += Threads[t]->join_ticks;
+        }
+        oss << "\n"
+            << "Splits : " << split_count << ", "
+            << (split_count ? double (split_ticks) / split_count : 0.0) << " ticks/split\n"
+            << "Joins  : " << join_count  << ", "
+            << (join_count  ? double (join_ticks)  / join_count  : 0.0) << " ticks/join\n";
+
+        return oss.str ();
     }
 
     void think ()
@@ -390,6 +598,7 @@ namespace Searcher {
         }
 
         Threads.sleep_idle = *(Options["Idle Threads Sleep"]);
+        UpcomingRepetition = *(Options["Upcoming Repetition"]);
         Threads.timer->run = true;
         Threads.timer->notify_one ();// Wake up the recurring timer
 
@@ -788,6 +997,14 @@ namespace {
                 return DrawValue[pos.active ()];
             }
 
+            // If a move repeats a position, the score is at least a draw
+            if (   UpcomingRepetition && alpha < DrawValue[pos.active ()]
+                && pos.upcoming_repetition ((ss+0)->ply - 1))
+            {
+                alpha = DrawValue[pos.active ()];
+                if (alpha >= beta) return alpha;
+            }
+
             // Step 3. Mate distance pruning. Even if we mate at the next move our score
             // would be at best mate_in((ss+0)->ply+1), but if alpha is already bigger because
             // a shorter mate was found upward in the tree then there is no need to search
@@ -1132,7 +1349,7 @@ moves_loop: // When in check and at SPNode search starts from here
             bool dangerous = gives_check || NORMAL != mtype (move) || pos.advanced_pawn_push (move);
 
             // Step 12. Extend checks
-            if (gives_check && pos.see_sign (move) >= 0) ext = ONE_MOVE;
+            if (gives_check && pos.see_ge (move, 0)) ext = ONE_MOVE;
 
             // Singular extension(SE) search. If all moves but one fail low on a search of
             // (alpha-s, beta-s), and just one fails high on (alpha, beta), then that move
@@ -1205,7 +1422,7 @@ moves_loop: // When in check and at SPNode search starts from here
                 }
 
                 // Prune moves with negative SEE at low depths
-                if (predicted_depth < 4 * ONE_MOVE && pos.see_sign (move) < 0)
+                if (predicted_depth < 4 * ONE_MOVE && !pos.see_ge (move, 0))
                 {
                     if (SPNode) split_point->mutex.lock ();
                     continue;
@@ -1389,6 +1606,11 @@ moves_loop: // When in check and at SPNode search starts from here
             }
         }
 
+        if (!SPNode && Searcher::Profile)
+        {
+            record_picks (thread, RootNode ? PICK_ROOT : PVNode ? PICK_PV : PICK_NONPV, mp);
+        }
+
         if (SPNode) return best_value;
 
         // Step 20. Check for mate and stalemate
@@ -1454,6 +1676,14 @@ moves_loop: // When in check and at SPNode search starts from here
             return DrawValue[pos.active ()];
         }
 
+        // If a move repeats a position, the score is at least a draw
+        if (   UpcomingRepetition && alpha < DrawValue[pos.active ()]
+            && pos.upcoming_repetition ((ss+0)->ply - 1))
+        {
+            alpha = DrawValue[pos.active ()];
+            if (alpha >= beta) return alpha;
+        }
+
         StateInfo   si;
 
         Move best_move = MOVE_NONE;
@@ -1579,7 +1809,7 @@ moves_loop: // When in check and at SPNode search starts from here
                 }
                 // Prune moves with negative or equal SEE and also moves with positive
                 // SEE where capturing piece loses a tempo and SEE < beta - futility_base.
-                if (futility_base < beta && pos.see (move) <= 0)
+                if (futility_base < beta && !pos.see_ge (move, 1))
                 {
                     if (futility_base > best_value) best_value = futility_base;
                     continue;
@@ -1596,7 +1826,7 @@ moves_loop: // When in check and at SPNode search starts from here
             if (!PVNode && (!IN_CHECK || evasion_prunable) &&
                 move != tt_move &&
                 mtype (move) != PROMOTE &&
-                pos.see_sign (move) < 0)
+                !pos.see_ge (move, 0))
             {
                 continue;
             }
@@ -1641,12 +1871,16 @@ moves_loop: // When in check and at SPNode search starts from here
                             value_to_tt (value, (ss+0)->ply),
                             (ss+0)->static_eval);
 
+                        if (Searcher::Profile) record_picks (pos.thread (), PVNode ? PICK_QS_PV : PICK_QS_NONPV, mp);
+
                         return value;
                     }
                 }
             }
         }
 
+        if (Searcher::Profile) record_picks (pos.thread (), PVNode ? PICK_QS_PV : PICK_QS_NONPV, mp);
+
         // All legal moves have been searched. A special case: If we're in check
         // and no legal moves were found, it is checkmate.
         if (IN_CHECK && best_value == -VALUE_INFINITE)
@@ -1907,12 +2141,20 @@ void Thread::idle_loop ()
 
             Threads.mutex.unlock ();
 
+            uint64_t ticks = Searcher::Profile ? cpu_ticks () : 0;
+
             Stack stack[MAX_PLY_6], *ss = stack+2; // To allow referencing (ss-2)
             Position pos (*sp->pos, this);
 
             std::memcpy (ss-2, sp->ss-2, 5 * sizeof (Stack));
             (ss+0)->split_point = sp;
 
+            if (Searcher::Profile)
+            {
+                join_ticks += cpu_ticks () - ticks;
+                ++join_count;
+            }
+
             sp->mutex.lock ();
 
             ASSERT (active_pos == NULL);
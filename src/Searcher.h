@@ -190,9 +190,17 @@ namespace Searcher {
 
     extern PolyglotBook          Book;
 
+    // When set, search() and search_quien() count per node type the moves
+    // generated and picked by the move picker
+    extern bool                  Profile;
+
 
     extern uint64_t perft (Position &pos, const Depth &depth);
 
+    extern void reset_profile ();
+
+    extern std::string profile ();
+
     extern void think ();
 
     extern void initialize ();
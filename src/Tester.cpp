@@ -1,12 +1,17 @@
 #include "Tester.h"
 
+#include <vector>
 //#include "xcstring.h"
 #include "xstring.h"
 
 #include "BitBoard.h"
 #include "BitCount.h"
+#include "BitBases.h"
 #include "Position.h"
 #include "Zobrist.h"
+#include "ScoreVec.h"
+#include "RKISS.h"
+#include "Thread.h"
 
 namespace Tester {
 
@@ -316,6 +321,13 @@ namespace Tester {
             ASSERT (pos.clock50 () == 4);
             ASSERT (pos.game_move () == 11);
 
+            // The bulk loader gives the same position, also from an EPD record
+            Key posi_key = pos.posi_key ();
+            const char *end = Position::load (pos, "rn3rk1/pbppq1pp/1p2pb2/4N2Q/3PN3/3B4/PPP2PPP/R3K2R w KQ - bm Qxh7+;");
+            ASSERT (end && pos.posi_key () == posi_key && pos.ok ());
+            end = Position::load (pos, "rn3rk1/pbppq1pp/1p2pb2/4N2Q/3PN3/3B4/PPP2PPP/R3K2R x KQ - 4 11");
+            ASSERT (!end);
+
             // ----
 
             fen = "8/8/1R5p/q5pk/PR3pP1/7P/8/7K b - g3 2 10";
@@ -419,6 +431,12 @@ namespace Tester {
 
             ASSERT (equals (buf, fen));
 
+            // X-FEN KQkq are the outermost rooks
+            Position::load (pos, "rkbnrnqb/pppppppp/8/8/8/8/PPPPPPPP/RKBNRNQB w KQkq - 0 1", NULL, true);
+            pos.fen (buf, true);
+
+            ASSERT (equals (buf, fen));
+
             cout << "FEN      ...done !!!" << endl;
 
         }
@@ -437,6 +455,90 @@ namespace Tester {
             pos.setup (fen);
             ASSERT (U64 (0x0000002000000000) == pos.discoverers (pos.active ()));
 
+            // see_ge() and see_batch() must agree with see()
+            const char *see_fens[] =
+            {
+                "1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1",
+                "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1",
+                "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                "4R3/2r3p1/5bk1/1p1r3p/p2PR1P1/P1BK1P2/1P6/8 b - - 0 1",
+                "rnbqkb1r/pp2pppp/5n2/2pP4/8/2N5/PP1P1PPP/R1BQKBNR w KQkq c6 0 4",
+            };
+            for (uint32_t i = 0; i < sizeof (see_fens) / sizeof (*see_fens); ++i)
+            {
+                pos.setup (see_fens[i]);
+
+                ValMove m_list[MAX_MOVES];
+                ValMove *end = MoveGenerator::generate<MoveGenerator::RELAX> (m_list, pos);
+                for (ValMove *itr = m_list; itr != end; ++itr)
+                {
+                    int32_t see = pos.see (itr->move);
+                    ASSERT (pos.see_ge (itr->move, see) && !pos.see_ge (itr->move, see + 1));
+                    for (int32_t threshold = -1200; threshold <= 1200; threshold += 25)
+                    {
+                        ASSERT (pos.see_ge (itr->move, threshold) == (see >= threshold));
+                    }
+                }
+                for (Square dst = SQ_A1; dst <= SQ_H8; ++dst)
+                {
+                    pos.see_batch (dst, m_list, end);
+                    for (ValMove *itr = m_list; itr != end; ++itr)
+                    {
+                        Move m = itr->move;
+                        if (dst_sq (m) != dst || ENPASSANT == mtype (m) || CASTLE == mtype (m)) continue;
+                        ASSERT (int32_t (itr->value) == pos.see (m));
+                    }
+                }
+
+                // The victim groups together hold the same captures as generate<CAPTURE>
+                const PieceT victims[] = { NONE, QUEN, ROOK, BSHP, NIHT, PAWN };
+                MoveGenerator::MoveList<MoveGenerator::CAPTURE> captures (pos);
+                ValMove *g_end = m_list;
+                for (uint32_t v = 0; v < sizeof (victims) / sizeof (*victims); ++v)
+                {
+                    g_end = MoveGenerator::generate_captures (g_end, pos, victims[v]);
+                }
+                ASSERT (uint32_t (g_end - m_list) == captures.size ());
+                for (ValMove *itr = m_list; itr != g_end; ++itr)
+                {
+                    ASSERT (captures.contains (itr->move));
+                }
+            }
+
+            // Generated castling moves pass pseudo_legal(), in standard and Chess960
+            {
+                pos.setup ("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+                for (MoveGenerator::MoveList<MoveGenerator::RELAX> itr (pos); *itr; ++itr)
+                {
+                    ASSERT (pos.pseudo_legal (*itr));
+                }
+                pos.setup ("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Qkq - 0 1");
+                ASSERT (!pos.pseudo_legal (mk_move<CASTLE> (SQ_E1, SQ_H1)));
+
+                pos.setup ("bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9", NULL, true);
+                for (MoveGenerator::MoveList<MoveGenerator::RELAX> itr (pos); *itr; ++itr)
+                {
+                    ASSERT (pos.pseudo_legal (*itr));
+                }
+                ASSERT (!pos.pseudo_legal (mk_move<CASTLE> (SQ_G1, SQ_H1)));
+            }
+
+            // Repetitions from the thread key history and from the StateInfo list
+            {
+                const char *moves[] = { "g1f3", "g8f6", "f3g1", "f6g8" };
+                StateInfo states[4];
+                Position rep_pos (FEN_N, Threads.main ());
+                ASSERT (!rep_pos.upcoming_repetition (MAX_PLY));
+                for (uint32_t i = 0; i < 4; ++i)
+                {
+                    if (3 == i) ASSERT (rep_pos.upcoming_repetition (MAX_PLY));
+                    string can = moves[i];
+                    rep_pos.do_move (can, states[i]);
+                    ASSERT (rep_pos.draw () == (3 == i));
+                    ASSERT (Position (rep_pos).draw () == (3 == i));
+                }
+            }
+
             cout << "Position ...done !!!" << endl;
         }
 
@@ -609,6 +711,71 @@ namespace Tester {
             cout << "Move     ...done !!!" << endl;
         }
 
+        // Scalar reference of the evaluation apply_weight()
+        Score apply_weight_scalar (Score s, Score w)
+        {
+            return mk_score (
+                (int32_t (mg_value (s)) * int32_t (mg_value (w))) / 0x100,
+                (int32_t (eg_value (s)) * int32_t (eg_value (w))) / 0x100);
+        }
+
+        void test_score ()
+        {
+            const int32_t N = 0x10000;
+
+            RKISS rkiss (1);
+            vector<Score> w_scores (N), b_scores (N), weights (N);
+            for (int32_t i = 0; i < N; ++i)
+            {
+                w_scores[i] = mk_score (int32_t (rkiss.rand64 () % 8001) - 4000, int32_t (rkiss.rand64 () % 8001) - 4000);
+                b_scores[i] = mk_score (int32_t (rkiss.rand64 () % 8001) - 4000, int32_t (rkiss.rand64 () % 8001) - 4000);
+                weights [i] = mk_score (int32_t (rkiss.rand64 () % 1024), int32_t (rkiss.rand64 () % 1024));
+            }
+
+            // Vector and scalar weighting must agree for both colors
+            for (int32_t i = 0; i < N; ++i)
+            {
+                ScoreVec sv = apply_weight (mk_score_vec (w_scores[i], b_scores[i]), mk_score_vec (weights[i], weights[i]));
+
+                ASSERT (color_score (sv, WHITE) == apply_weight_scalar (w_scores[i], weights[i]));
+                ASSERT (color_score (sv, BLACK) == apply_weight_scalar (b_scores[i], weights[i]));
+                ASSERT (score_diff (sv) == apply_weight_scalar (w_scores[i], weights[i]) - apply_weight_scalar (b_scores[i], weights[i]));
+                ASSERT (score_diff (mk_score_vec (w_scores[i], b_scores[i])) == w_scores[i] - b_scores[i]);
+            }
+
+            // Compare speed of weighting both colors, the vector path is the slower
+            // one, which is why the evaluation keeps the scalar apply_weight()
+            Score sum_scalar = SCORE_ZERO;
+            uint64_t ticks = cpu_ticks ();
+            for (int32_t i = 0; i < N; ++i)
+            {
+                sum_scalar += apply_weight_scalar (w_scores[i], weights[i]) - apply_weight_scalar (b_scores[i], weights[i]);
+            }
+            uint64_t ticks_scalar = cpu_ticks () - ticks;
+
+            Score sum_vector = SCORE_ZERO;
+            ticks = cpu_ticks ();
+            for (int32_t i = 0; i < N; ++i)
+            {
+                sum_vector += score_diff (apply_weight (mk_score_vec (w_scores[i], b_scores[i]), mk_score_vec (weights[i], weights[i])));
+            }
+            uint64_t ticks_vector = cpu_ticks () - ticks;
+
+            ASSERT (sum_scalar == sum_vector);
+
+            cout << "Score    ...done !!! (scalar " << ticks_scalar << " ticks, vector " << ticks_vector << " ticks)" << endl;
+        }
+
+        void test_bitbases ()
+        {
+            // Regenerating the KPK bitbase must give the embedded one
+            vector<uint32_t> kpk (BitBases::KPK_SIZE);
+            BitBases::generate_kpk (&kpk[0]);
+            ASSERT (equal (kpk.begin (), kpk.end (), BitBases::KPKBitbase));
+
+            cout << "BitBases ...done !!!" << endl;
+        }
+
         void test_uci ()
         {
 
@@ -625,6 +792,8 @@ namespace Tester {
 
         test_attacks ();
 
+        test_bitbases ();
+
         test_fen ();
 
         test_position ();
@@ -633,6 +802,8 @@ namespace Tester {
 
         test_move ();
 
+        test_score ();
+
         test_uci ();
     }
 
@@ -67,6 +67,8 @@ Thread::Thread () /* : split_points() */  // Value-initialization bug in MSVC
     max_ply = threads_split_point = 0;
     active_split_point = NULL;
     active_pos = NULL;
+    move_stack_top = move_stack;
+    split_count = split_ticks = join_count = join_ticks = 0;
     idx = Threads.size ();
 }
 
@@ -149,7 +151,7 @@ void MainThread::idle_loop ()
 // init() is called at startup to create and launch requested threads, that will
 // go immediately to sleep due to 'sleep_idle' set to true.
 // We cannot use a c'tor becuase Threads is a static object and we need a fully initialized
-// engine at this point due to allocation of Endgames in Thread c'tor.
+// engine at this point due to allocation of the hash tables in Thread c'tor.
 void ThreadPool::initialize ()
 {
     sleep_idle = true;
@@ -232,6 +234,8 @@ void Thread::split (Position &pos, const Stack ss[], Value alpha, Value beta, Va
     ASSERT (searching);
     ASSERT (threads_split_point < MAX_THREADS_SPLIT_POINT);
 
+    uint64_t ticks = Searcher::Profile ? cpu_ticks () : 0;
+
     // Pick the next available split point from the split point stack
     SplitPoint &sp = split_points[threads_split_point];
 
@@ -283,8 +287,16 @@ void Thread::split (Position &pos, const Stack ss[], Value alpha, Value beta, Va
         sp.mutex.unlock ();
         Threads.mutex.unlock ();
 
+        if (Searcher::Profile)
+        {
+            split_ticks += cpu_ticks () - ticks;
+            ++split_count;
+        }
+
         Thread::idle_loop (); // Force a call to base class idle_loop()
 
+        if (Searcher::Profile) ticks = cpu_ticks ();
+
         // In helpful master concept a master can help only a sub-tree of its split
         // point, and because here is all finished is not possible master is booked.
         ASSERT (!searching);
@@ -310,6 +322,8 @@ void Thread::split (Position &pos, const Stack ss[], Value alpha, Value beta, Va
 
     sp.mutex.unlock ();
     Threads.mutex.unlock ();
+
+    if (Searcher::Profile && (slaves_count > 1 || FAKE)) split_ticks += cpu_ticks () - ticks;
 }
 
 // Explicit template instantiations
@@ -321,6 +335,8 @@ template void Thread::split< true> (Position&, const Stack[], Value, Value, Valu
 void ThreadPool::start_thinking (const Position &pos, const LimitsT &limits, StateInfoStackPtr &states)
 {
     wait_for_think_finished ();
+    // No search is running, apply the shared material table option
+    Material::apply_shared ();
 
     SearchTime = Time::now (); // As early as possible
 
@@ -331,6 +347,7 @@ void ThreadPool::start_thinking (const Position &pos, const LimitsT &limits, Sta
 
     RootMoves.clear();
     RootPos     = pos;
+    RootPos.sync_key_history ();
     RootColor   = pos.active ();
     Limits      = limits;
     if (states.get ()) // If we don't set a new position, preserve current state
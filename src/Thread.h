@@ -12,6 +12,12 @@
 const int32_t MAX_THREADS             = 64; // Because SplitPoint::slaves_mask is a uint64_t
 const int32_t MAX_THREADS_SPLIT_POINT = 8;  // Maximum threads per split point
 const int32_t MAX_SPLIT_DEPTH         = 15; // Maximum split depth
+// Move lists of the move pickers alive at once on a thread: the main and the
+// singular extension pickers of each ply at most.
+const int32_t MAX_MOVE_STACK          = 2 * MAX_PLY_6 * MAX_MOVES;
+// Keys kept for repetition detection: the fifty move window (at most 100 plies)
+// behind the search root and the search path itself, a power of 2.
+const int32_t MAX_KEY_HISTORY         = 256;
 
 #ifndef _WIN32 // Linux - Unix
 
@@ -159,7 +165,24 @@ struct Thread
     SplitPoint           split_points[MAX_THREADS_SPLIT_POINT];
     Material::Table      material_table;
     Pawns   ::Table      pawns_table;
-    EndGame ::Endgames   endgames;
+
+    // Move-stack arena, each MovePicker carves its move list from the top
+    // and gives it back when destroyed, so nodes touch only the moves used.
+    ValMove              move_stack[MAX_MOVE_STACK];
+    ValMove             *move_stack_top;
+
+    // Position keys along the path to the thread's current position, indexed
+    // by game ply, so that draw() reads them contiguously instead of walking
+    // the StateInfo list.
+    Key                  key_history[MAX_KEY_HISTORY];
+
+    // Split overhead, counted while Searcher::Profile is set: the splits done
+    // as master with the ticks spent in split() outside the search, and the
+    // split points joined with the ticks spent setting up the position.
+    uint64_t             split_count
+        ,                split_ticks
+        ,                join_count
+        ,                join_ticks;
 
     Position            *active_pos;
     
@@ -403,5 +426,64 @@ extern void prefetch (char *addr);
 //    return ss.str ();
 //}
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#   include <intrin.h>
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#   include <cpuid.h>
+#endif
+
+// cpu_has_popcnt() tests the POPCNT feature bit (CPUID leaf 1, ECX bit 23),
+// the same test the loader does to pick the HOT_KERNEL clones.
+inline bool cpu_has_popcnt ()
+{
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+
+    int32_t regs[4];
+    __cpuid (regs, 1);
+    return (regs[2] & (1 << 23));
+
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+
+    uint32_t eax, ebx, ecx, edx;
+    if (!__get_cpuid (1, &eax, &ebx, &ecx, &edx)) return false;
+    return (ecx & (1 << 23));
+
+#else
+
+    return false;
+
+#endif
+
+}
+
+// cpu_has_bmi2() tests the BMI2 feature bit (CPUID leaf 7, EBX bit 8),
+// a PEXT build must not run on a CPU without it.
+inline bool cpu_has_bmi2 ()
+{
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+
+    int32_t regs[4];
+    __cpuid (regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuidex (regs, 7, 0);
+    return (regs[1] & (1 << 8));
+
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid_max (0, NULL) < 7) return false;
+    __cpuid_count (7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 8));
+
+#else
+
+    return false;
+
+#endif
+
+}
+
 
 #endif // THREAD_H_
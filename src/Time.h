@@ -22,6 +22,9 @@ INLINE uint64_t system_time_msec ()
     return ((timebuf.time * 1000LL) + timebuf.millitm);
 }
 
+// _ftime() has only millisecond resolution
+INLINE uint64_t system_time_usec () { return system_time_msec () * 1000LL; }
+
 #else           // LINUX - UNIX
 
 #   include <sys/time.h>
@@ -33,6 +36,44 @@ INLINE uint64_t system_time_msec ()
     return ((timebuf.tv_sec * 1000LL) + (timebuf.tv_usec / 1000));
 }
 
+INLINE uint64_t system_time_usec ()
+{
+    timeval timebuf;
+    gettimeofday (&timebuf, NULL);
+    return ((timebuf.tv_sec * 1000000LL) + timebuf.tv_usec);
+}
+
+#endif
+
+// cpu_ticks() returns a fast, monotonic tick counter used for profiling.
+// On x86 this is the time-stamp counter (cycles), elsewhere it falls back
+// to the steady clock in nanoseconds.
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+
+#   include <intrin.h>
+
+INLINE uint64_t cpu_ticks () { return __rdtsc (); }
+
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+
+#   include <x86intrin.h>
+
+INLINE uint64_t cpu_ticks () { return __rdtsc (); }
+
+#elif __cplusplus > 199711L
+
+#   include <chrono>
+
+INLINE uint64_t cpu_ticks ()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+#else
+
+INLINE uint64_t cpu_ticks () { return system_time_msec () * 1000000LL; }
+
 #endif
 
 namespace Time {
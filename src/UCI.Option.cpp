@@ -8,6 +8,7 @@
 
 #include "Transposition.h"
 #include "Evaluator.h"
+#include "Material.h"
 #include "Searcher.h"
 #include "Thread.h"
 #include "DebugLogger.h"
@@ -240,6 +241,11 @@ namespace UCI {
             Evaluator::initialize ();
         }
 
+        void on_change_material (const Option &opt)
+        {
+            Material::initialize_shared (bool (opt));
+        }
+
         void on_change_50_move_distance (const Option &opt)
         {
             Position::fifty_move_distance = 2 * int32_t (opt);
@@ -364,6 +370,12 @@ namespace UCI {
 
         Options["Idle Threads Sleep"]           = OptionPtr (new CheckOption (true));
 
+        // Precompute the material entries of the common configurations at startup
+        // into one read-only table shared by all the threads. Each thread keeps its
+        // own material hash table as the fallback for the other configurations.
+        // A change takes effect at the start of the next search.
+        Options["Shared Material Table"]        = OptionPtr (new CheckOption (false, on_change_material));
+
         // Game Play Options
         // -----------------
 
@@ -460,6 +472,10 @@ namespace UCI {
         // It's a reasonably generic way to decide whether a material advantage can be converted or not.
         Options["Fifty Move Distance"]          = OptionPtr (new SpinOption (50,  5, 50, on_change_50_move_distance));
 
+        // Score at least as a draw the nodes where the side to move has a move
+        // repeating an earlier position, found with cuckoo tables of the moves.
+        Options["Upcoming Repetition"]          = OptionPtr (new CheckOption (false));
+
         // TODO::
         // Maximum search depth for mate search.
         // Default 0, min 0, max 99.
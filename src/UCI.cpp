@@ -1,6 +1,7 @@
 #include "UCI.h"
 
 #include <iostream>
+#include <fstream>
 #include <cstdarg>
 #include "xstring.h"
 
@@ -9,6 +10,7 @@
 #include "Searcher.h"
 #include "Evaluator.h"
 #include "Benchmark.h"
+#include "BitBases.h"
 #include "Notation.h"
 #include "TriLogger.h"
 #include "Thread.h"
@@ -332,6 +334,40 @@ namespace UCI {
             }
         }
 
+        // exe_kpk() regenerates the KPK bitbase into the given file,
+        // by default BitBases.KPK.h in the current directory.
+        void exe_kpk (cmdstream &cstm)
+        {
+            string fn = "BitBases.KPK.h";
+            cstm >> fn;
+            ofstream ofs (fn.c_str ());
+            if (!ofs.is_open ())
+            {
+                sync_cout << "Cannot open " << fn << sync_endl;
+                return;
+            }
+            BitBases::write_kpk (ofs);
+            ofs.close ();
+            sync_cout << "KPK bitbase written to " << fn << sync_endl;
+        }
+
+        // exe_profile() runs a benchmark (same arguments as "bench") with the
+        // evaluation and move picker profilers switched on and prints the
+        // per-stage and per-node type breakdowns.
+        void exe_profile (cmdstream &cstm)
+        {
+            Evaluator::reset_profile ();
+            Searcher ::reset_profile ();
+            Evaluator::Profile = true;
+            Searcher ::Profile = true;
+            benchmark (cstm, RootPos);
+            Evaluator::Profile = false;
+            Searcher ::Profile = false;
+
+            cerr << "\n" << Evaluator::profile ()
+                << "\n" << Searcher ::profile () << endl;
+        }
+
         void exe_stop ()
         {
             Signals.stop = true;
@@ -382,6 +418,10 @@ namespace UCI {
                 else if (iequals (token, "eval"))       exe_eval ();
                 else if (iequals (token, "perft"))      exe_perft (cstm);
                 else if (iequals (token, "bench"))      benchmark (cstm, RootPos);
+                else if (iequals (token, "profile"))    exe_profile (cstm);
+                else if (iequals (token, "sliders"))    benchmark_sliders (cstm);
+                else if (iequals (token, "fenbench"))   benchmark_fen (cstm);
+                else if (iequals (token, "kpk"))        exe_kpk (cstm);
                 else if (iequals (token, "stop")
                     ||   iequals (token, "quit"))       exe_stop ();
                 else
@@ -387,8 +387,8 @@ namespace Zobrist {
 
 }
 
-// Random numbers from PolyGlot, used to compute book hash keys
-const Zobrist::Zob ZobPG =
+// Random numbers from PolyGlot, used to compute position and book hash keys
+CACHE_ALIGN(64) const Zobrist::Zob ZobPG =
 {
 
     // WHITE_PAWN
@@ -620,7 +620,3 @@ const Zobrist::Zob ZobPG =
 };
 
 //Zobrist::Zob ZobRand;
-
-const Zobrist::Zob &ZobGlob =
-    //ZobRand;
-    ZobPG;
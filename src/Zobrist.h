@@ -61,8 +61,10 @@ namespace Zobrist {
 
 }
 
-extern const Zobrist::Zob ZobPG;
+// The engine hashes with the PolyGlot random numbers, so the incrementally
+// updated posi_key is also the book key. Aligned so that the keys of each
+// piece type fill exactly 8 cache lines and the rest fits in 2 more.
+CACHE_ALIGN(64) extern const Zobrist::Zob ZobPG;
 //extern       Zobrist::Zob ZobRand;
-extern const Zobrist::Zob &ZobGlob;
 
 #endif